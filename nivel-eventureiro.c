@@ -3,6 +3,8 @@
 #include <string.h>
 #include <time.h>
 
+#include "war_csv.h"
+
 // Estrutura que representa cada território
 typedef struct {
     char nome[30];
@@ -12,40 +14,60 @@ typedef struct {
 
 // Funções (prototipos)
 Territorio* cadastrarTerritorios(int n);
+Territorio* importarTerritorios(const char* caminho, int* n);
 void exibirMapa(Territorio* mapa, int n);
+void exibirTerritorios(Territorio* mapa, const int* indices, int k);
 void atacar(Territorio* atacante, Territorio* defensor);
 void liberarMemoria(Territorio* mapa);
-int lerInteiro(const char* msg, int min, int max);
+int lerInteiro(const char* msg, int min, int max, int* valor);
 
 // Programa principal
-int main() {
+// Uso: nivel-eventureiro [cenario.csv | -]
+// Com um arquivo (ou "-" para a entrada padrão) os territórios são importados
+// de uma vez, sem perguntas; sem argumentos, o cadastro é interativo.
+int main(int argc, char** argv) {
     srand((unsigned) time(NULL)); // inicializa gerador de números aleatórios
 
     printf("=== WAR Estruturado - Simulação de Ataques entre Territ\xf3rios ===\n\n");
 
-    int n = lerInteiro("Quantos territ\xf3rios deseja cadastrar? (min 2): ", 2, 1000);
+    int n = 0;
+    Territorio* mapa = NULL;
+    if (argc > 1) {
+        mapa = importarTerritorios(argv[1], &n);
+        if (!mapa) return 1; // o erro (com a linha) já foi exibido
+        printf("%d territ\xf3rios importados de %s.\n", n, argv[1]);
+    } else {
+        if (!lerInteiro("Quantos territ\xf3rios deseja cadastrar? (min 2): ", 2, 1000, &n)) return 1;
 
-    // Aloca dinamicamente o vetor de territórios
-    Territorio* mapa = cadastrarTerritorios(n);
-    if (!mapa) {
-        fprintf(stderr, "Erro: falha na aloca\xe7\xe3o de mem\xf3ria.\n");
-        return 1;
+        // Aloca dinamicamente o vetor de territórios
+        mapa = cadastrarTerritorios(n);
+        if (!mapa) {
+            fprintf(stderr, "Erro: falha na aloca\xe7\xe3o de mem\xf3ria ou entrada encerrada.\n");
+            return 1;
+        }
     }
 
     int opcao = 0;
+    int mapaExibido = 0; // depois da primeira vez, cada ataque mostra só as linhas que mudaram
     while (1) {
         printf("\n--- Menu ---\n");
         printf("1 - Exibir mapa\n");
         printf("2 - Fazer ataque\n");
         printf("3 - Sair\n");
-        opcao = lerInteiro("Escolha uma opcao: ", 1, 3);
+        if (!lerInteiro("Escolha uma opcao: ", 1, 3, &opcao)) opcao = 3; // fim da entrada: sai
 
         if (opcao == 1) {
             exibirMapa(mapa, n);
+            mapaExibido = 1;
         } else if (opcao == 2) {
-            exibirMapa(mapa, n);
-            int idAtacante = lerInteiro("Indice do territorio atacante: ", 0, n-1);
-            int idDefensor = lerInteiro("Indice do territorio defensor: ", 0, n-1);
+            if (!mapaExibido) exibirMapa(mapa, n);
+            mapaExibido = 1;
+            int idAtacante, idDefensor;
+            if (!lerInteiro("Indice do territorio atacante: ", 0, n-1, &idAtacante) ||
+                !lerInteiro("Indice do territorio defensor: ", 0, n-1, &idDefensor)) {
+                printf("Saindo... liberando memoria.\n");
+                break;
+            }
 
             // Validacoes
             if (idAtacante == idDefensor) {
@@ -69,9 +91,10 @@ int main() {
             // Realiza o ataque usando ponteiros
             atacar(atacante, defensor);
 
-            // Exibe resultado atualizado
-            printf("\nMapa atualizado ap\xf3s o ataque:\n");
-            exibirMapa(mapa, n);
+            // Exibe só os dois territórios que o ataque alterou
+            int alterados[2] = {idAtacante, idDefensor};
+            printf("\nTerrit\xf3rios alterados pelo ataque:\n");
+            exibirTerritorios(mapa, alterados, 2);
 
         } else if (opcao == 3) {
             printf("Saindo... liberando memoria.\n");
@@ -84,14 +107,15 @@ int main() {
 }
 
 // Lê um inteiro do usuário entre min e max (inclusive). Repetir até entrada válida.
-int lerInteiro(const char* msg, int min, int max) {
+// Retorna 0 se a entrada acabar (EOF), em vez de perguntar de novo para sempre.
+int lerInteiro(const char* msg, int min, int max, int* valor) {
     int val;
     char buf[64];
     while (1) {
         printf("%s", msg);
         if (!fgets(buf, sizeof(buf), stdin)) {
-            clearerr(stdin);
-            continue;
+            printf("\nFim da entrada.\n");
+            return 0;
         }
         if (sscanf(buf, "%d", &val) != 1) {
             printf("Entrada invalida. Tente novamente.\n");
@@ -101,7 +125,8 @@ int lerInteiro(const char* msg, int min, int max) {
             printf("Valor fora do intervalo [%d - %d]. Tente novamente.\n", min, max);
             continue;
         }
-        return val;
+        *valor = val;
+        return 1;
     }
 }
 
@@ -135,20 +160,107 @@ Territorio* cadastrarTerritorios(int n) {
             mapa[i].cor[sizeof(mapa[i].cor)-1] = '\0';
         }
 
-        mapa[i].tropas = lerInteiro("Quantidade de tropas (>0): ", 1, 1000000);
+        if (!lerInteiro("Quantidade de tropas (>0): ", 1, MAX_TROPAS_CSV, &mapa[i].tropas)) {
+            free(mapa);
+            return NULL;
+        }
     }
 
     return mapa;
 }
 
+// Importa os territorios de um cenario em texto (nome,cor,tropas por linha; ver war_csv.h)
+// sem nenhum prompt. "-" le da entrada padrao. O vetor dobra de tamanho conforme
+// as linhas chegam e no fim e ajustado ao total, ficando numa unica alocacao.
+// Em caso de erro mostra a linha e retorna NULL.
+Territorio* importarTerritorios(const char* caminho, int* n) {
+    int entradaPadrao = strcmp(caminho, "-") == 0;
+    FILE* f = entradaPadrao ? stdin : fopen(caminho, "r");
+    if (!f) {
+        perror(caminho);
+        return NULL;
+    }
+    LeitorCsv leitor;
+    int capacidade = 64, total = 0;
+    Territorio* mapa = (Territorio*) malloc(sizeof(Territorio) * capacidade);
+    if (!mapa || !abrirLeitorCsv(&leitor, f)) {
+        fprintf(stderr, "Erro: falha na aloca\xe7\xe3o de mem\xf3ria.\n");
+        free(mapa);
+        if (!entradaPadrao) fclose(f);
+        return NULL;
+    }
+
+    TerritorioCsv t;
+    ErroImportacao erro;
+    int r;
+    while ((r = lerTerritorioCsv(&leitor, &t, &erro)) == 1) {
+        if (t.tamanhoNome >= sizeof(mapa[0].nome) || t.tamanhoCor >= sizeof(mapa[0].cor)) {
+            erro.linha = t.linha;
+            snprintf(erro.mensagem, sizeof(erro.mensagem), "nome (max %d) ou cor (max %d) longos demais",
+                     (int) sizeof(mapa[0].nome) - 1, (int) sizeof(mapa[0].cor) - 1);
+            r = -1;
+            break;
+        }
+        if (total == capacidade) {
+            Territorio* maior = (Territorio*) realloc(mapa, sizeof(Territorio) * capacidade * 2);
+            if (!maior) {
+                erro.linha = t.linha;
+                strcpy(erro.mensagem, "falta de memoria");
+                r = -1;
+                break;
+            }
+            mapa = maior;
+            capacidade *= 2;
+        }
+        memcpy(mapa[total].nome, t.nome, t.tamanhoNome + 1);
+        memcpy(mapa[total].cor, t.cor, t.tamanhoCor + 1);
+        mapa[total].tropas = t.tropas;
+        total++;
+    }
+    fecharLeitorCsv(&leitor);
+    if (!entradaPadrao) fclose(f);
+
+    if (r == 0 && total < 2) {
+        erro.linha = 0;
+        strcpy(erro.mensagem, "o cenario precisa de pelo menos 2 territorios");
+        r = -1;
+    }
+    if (r < 0) {
+        if (erro.linha > 0) fprintf(stderr, "%s:%d: %s\n", caminho, erro.linha, erro.mensagem);
+        else fprintf(stderr, "%s: %s\n", caminho, erro.mensagem);
+        free(mapa);
+        return NULL;
+    }
+    Territorio* ajustado = (Territorio*) realloc(mapa, sizeof(Territorio) * total);
+    *n = total;
+    return ajustado ? ajustado : mapa;
+}
+
 // Exibe o mapa atual com indices para selecao
 void exibirMapa(Territorio* mapa, int n) {
     printf("\n--- Mapa de Territorios ---\n");
-    printf("Indice | Nome                         | Cor       | Tropas\n");
-    printf("---------------------------------------------------------\n");
-    for (int i = 0; i < n; ++i) {
-        printf("%5d  | %-27s | %-8s | %6d\n", i, mapa[i].nome, mapa[i].cor, mapa[i].tropas);
+    exibirTerritorios(mapa, NULL, n);
+}
+
+// Exibe a tabela com os territorios indicados (todos os k primeiros se indices == NULL).
+// As linhas sao montadas num buffer e escritas com um fwrite por bloco, nao um printf por linha.
+void exibirTerritorios(Territorio* mapa, const int* indices, int k) {
+    char texto[8192];
+    size_t usados = (size_t) snprintf(texto, sizeof(texto),
+                                      "Indice | Nome                         | Cor       | Tropas\n"
+                                      "---------------------------------------------------------\n");
+    for (int j = 0; j < k; ++j) {
+        if (usados + 128 > sizeof(texto)) {
+            fwrite(texto, 1, usados, stdout);
+            usados = 0;
+        }
+        int i = indices ? indices[j] : j;
+        int escritos = snprintf(texto + usados, 128, "%5d  | %-27s | %-8s | %6d\n", i, mapa[i].nome, mapa[i].cor,
+                                mapa[i].tropas);
+        if (escritos > 0) usados += escritos < 128 ? (size_t) escritos : 127;
     }
+    fwrite(texto, 1, usados, stdout);
+    fflush(stdout);
 }
 
 // Função que simula um ataque entre dois territories.
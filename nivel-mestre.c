@@ -1,238 +1,217 @@
 /* war_missoes.c
    Implementação das missões estratégicas para cada jogador no estilo "War".
    Requisitos: modularização, ponteiros, malloc/free, uso de strcpy para atribuir missões.
+   As regras (missões, ataque, contadores) ficam em war_jogo.c.
 */
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
-#define MAX_NOME 30
-#define MAX_COR 10
+#include "war_arena.h"
+#include "war_arquivo.h"
+#include "war_conselheiro.h"
+#include "war_eventos.h"
+#include "war_historico.h"
+#include "war_jogo.h"
+#include "war_mcts.h"
+#include "war_metricas.h"
+#include "war_regras.h"
+#include "war_tela.h"
 
-typedef struct {
-    char nome[30];
-    char cor[10]; // cor do dono (ex: "Vermelho", "Azul", "Verde", "Amarelo")
-    int tropas;
-} Territorio;
+#define AMOSTRAS_CONSELHEIRO 20000
 
-/* ----------------------- Assinaturas das funções ----------------------- */
-void atribuirMissao(char* destino, char* missoes[], int totalMissoes);
-int verificarMissao(char* missao, Territorio* mapa, int tamanho, const char* corJogador);
-void exibirMissao(const char* missao); // passagem por valor para exibir (const char*)
-void atacar(Territorio* atacante, Territorio* defensor);
-void exibirMapa(Territorio* mapa, int tamanho);
-void liberarMemoria(Territorio* mapa, int tamanho, char** missoesJogadores, int numJogadores);
-int contarTerritoriosDoJogador(Territorio* mapa, int tamanho, const char* corJogador);
-int somarTropasDoJogador(Territorio* mapa, int tamanho, const char* corJogador);
-int existeTerritorioComNome(Territorio* mapa, int tamanho, const char* nome);
-
-/* ----------------------- Implementação ----------------------- */
-
-/* Sorteia uma missão do vetor missoes[] e copia para destino usando strcpy.
-   Supõe-se que 'destino' já foi alocado com espaço suficiente. */
-void atribuirMissao(char* destino, char* missoes[], int totalMissoes) {
-    int idx = rand() % totalMissoes;
-    strcpy(destino, missoes[idx]);
-}
-
-/* Verifica se a missão (string com formato "id|descrição") foi cumprida.
-   Retorna 1 se cumprida, 0 caso contrário.
-   Recebe também a cor do jogador para verificar objetivos relacionados ao jogador. */
-int verificarMissao(char* missao, Territorio* mapa, int tamanho, const char* corJogador) {
-    int id = 0;
-    char descricao[200];
-    // separa id e descrição (ex: "1|Conquistar 3 territorios")
-    char* sep = strchr(missao, '|');
-    if (!sep) return 0;
-    int len_id = sep - missao;
-    char id_str[10] = {0};
-    strncpy(id_str, missao, len_id);
-    id = atoi(id_str);
-    strcpy(descricao, sep + 1);
-
-    // Implementação simples para cada id de missão
-    switch (id) {
-        case 1: { // Conquistar 3 territórios (ter >= 3 territórios)
-            int cnt = contarTerritoriosDoJogador(mapa, tamanho, corJogador);
-            if (cnt >= 3) return 1;
-            return 0;
+/* Comando de chances: lê "atacante alvo [alvo ...]" (cada alvo atacado a
+   partir do anterior, até conquistar ou zerar as tropas) e mostra a chance
+   exata de conquistar a cadeia inteira, conferida por Monte Carlo. */
+static void exibirChances(const EstadoJogo* estado, ConselheiroAtaque* conselheiro, GeradorAleatorio* g,
+                          const char* linha) {
+    const Mapa* mapa = estado->mapa;
+    int indices[MAX_CADEIA + 1];
+    int total = 0;
+    char* fim;
+    for (long v = strtol(linha, &fim, 10); fim != linha && total <= MAX_CADEIA; v = strtol(linha, &fim, 10)) {
+        if (v < 0 || v >= mapa->tamanho) {
+            printf("Índice inválido: %ld.\n", v);
+            return;
         }
-        case 2: { // Eliminar todas as tropas da cor Vermelha (exemplo: 'Vermelho')
-            int existe = 0;
-            for (int i = 0; i < tamanho; ++i) {
-                if (strcmp(mapa[i].cor, "Vermelho") == 0 && mapa[i].tropas > 0) {
-                    existe = 1; break;
-                }
-            }
-            return !existe; // true se não existir tropas vermelhas
-        }
-        case 3: { // Controlar todos os territórios (vencer o jogo)
-            int cnt = contarTerritoriosDoJogador(mapa, tamanho, corJogador);
-            return (cnt == tamanho);
-        }
-        case 4: { // Ter ao menos 10 tropas no total
-            int total = somarTropasDoJogador(mapa, tamanho, corJogador);
-            return (total >= 10);
+        indices[total++] = (int) v;
+        linha = fim;
+    }
+    if (total < 2) {
+        printf("Informe o atacante e pelo menos um alvo.\n");
+        return;
+    }
+    int tropasDefensores[MAX_CADEIA];
+    for (int i = 1; i < total; ++i) {
+        if (!fazemFronteira(estado, indices[i - 1], indices[i])) {
+            printf("%s não faz fronteira com %s.\n", nomeDoTerritorio(mapa, indices[i]),
+                   nomeDoTerritorio(mapa, indices[i - 1]));
+            return;
         }
-        case 5: { // Conquistar o território "Território X" (exemplo)
-            // vamos extrair um nome esperado depois do texto, mas para simplicidade,
-            // assumimos que missão 5 pede um território fixo "Fortaleza"
-            const char* alvo = "Fortaleza";
-            for (int i = 0; i < tamanho; ++i) {
-                if (strcmp(mapa[i].nome, alvo) == 0 && strcmp(mapa[i].cor, corJogador) == 0)
-                    return 1;
-            }
-            return 0;
+        if (mapa->dono[indices[i]] == mapa->dono[indices[0]]) {
+            printf("%s já pertence ao atacante.\n", nomeDoTerritorio(mapa, indices[i]));
+            return;
         }
-        default:
-            return 0;
-    }
-}
-
-/* Exibe a missão (passagem por valor do ponteiro const char*). */
-void exibirMissao(const char* missao) {
-    char* sep = strchr(missao, '|');
-    if (sep) {
-        printf("Sua missão: %s\n", sep + 1);
-    } else {
-        printf("Sua missão: %s\n", missao);
+        tropasDefensores[i - 1] = mapa->tropas[indices[i]];
     }
+    int tropas = mapa->tropas[indices[0]];
+    ChancesAtaque exata = avaliarCadeia(conselheiro, tropas, tropasDefensores, total - 1);
+    ChancesAtaque estimada = estimarCadeiaMonteCarlo(g, conselheiro->tentativasPorAlvo, tropas,
+                                                     tropasDefensores, total - 1, AMOSTRAS_CONSELHEIRO);
+    printf("Chance de conquistar %d alvo(s) a partir de %s: %.2f%% | tropas esperadas ao final: %.2f\n",
+           total - 1, nomeDoTerritorio(mapa, indices[0]), 100.0 * exata.probConquista, exata.tropasRestantes);
+    printf("(Monte Carlo, %d amostras: %.2f%% | %.2f)\n", AMOSTRAS_CONSELHEIRO,
+           100.0 * estimada.probConquista, estimada.tropasRestantes);
+    if (WAR_REGRAS != REGRAS_1X1) printf("(as chances seguem a regra 1x1; este jogo usa a regra %s)\n", NOME_REGRAS);
 }
 
-/* Simulação do ataque entre territorios.
-   Usa rand() para rolagem (1..6) para atacante e defensor.
-   Se atacante vence (soma maior), transfere cor e metade das tropas ao defensor.
-   Caso perca, atacante perde 1 tropa. */
-void atacar(Territorio* atacante, Territorio* defensor) {
-    if (!atacante || !defensor) return;
-    if (strcmp(atacante->cor, defensor->cor) == 0) {
-        printf("Ataque inválido: mesmo dono.\n");
+/* Comando de gravação: salva mapa, fronteiras, jogadores, missões e turno
+   para continuar depois com ./nivel-mestre <arquivo>. */
+static void gravarPartida(const Mapa* mapa, const GrafoMapa* grafo, const int* donosJogadores,
+                          char** missoesJogadores, int numJogadores, int turno, const char* linha) {
+    char caminho[100];
+    if (sscanf(linha, "%99s", caminho) != 1) {
+        printf("Informe o nome do arquivo.\n");
         return;
     }
-    if (atacante->tropas <= 0) {
-        printf("%s não tem tropas suficientes para atacar.\n", atacante->nome);
-        return;
-    }
-
-    int rollA = (rand() % 6) + 1;
-    int rollD = (rand() % 6) + 1;
-    printf("Rolagem atacante (%s) = %d | defensor (%s) = %d\n", atacante->nome, rollA, defensor->nome, rollD);
-    if (rollA > rollD) {
-        // atacante vence: transfere cor e metade das tropas (arredonda para baixo)
-        int transfer = atacante->tropas / 2;
-        if (transfer == 0) transfer = 1; // garante ao menos 1 tropa transferida
-        printf("Atacante vence! Transferindo %d tropas e mudando cor de %s para %s\n",
-               transfer, defensor->nome, atacante->cor);
-        strcpy(defensor->cor, atacante->cor);
-        defensor->tropas = transfer;
-        atacante->tropas -= transfer;
-        if (atacante->tropas < 0) atacante->tropas = 0;
-    } else {
-        // atacante perde 1 tropa
-        atacante->tropas -= 1;
-        if (atacante->tropas < 0) atacante->tropas = 0;
-        printf("Defensor resiste! %s perde 1 tropa (agora tem %d).\n", atacante->nome, atacante->tropas);
-    }
-}
-
-/* Exibe o mapa com nome, cor e tropas de cada território. */
-void exibirMapa(Territorio* mapa, int tamanho) {
-    printf("\nMapa atual:\n");
-    printf("Idx | Nome                 | Cor       | Tropas\n");
-    printf("----+----------------------+-----------+-------\n");
-    for (int i = 0; i < tamanho; ++i) {
-        printf("%3d | %-20s | %-9s | %5d\n", i, mapa[i].nome, mapa[i].cor, mapa[i].tropas);
+    JogadorSalvo jogadores[MAX_JOGADORES_SALVOS];
+    for (int i = 0; i < numJogadores; ++i) {
+        jogadores[i].dono = donosJogadores[i];
+        jogadores[i].idMissao = idDaMissao(missoesJogadores[i]);
     }
-    printf("\n");
+    if (salvarJogo(caminho, mapa, grafo, jogadores, numJogadores, turno))
+        printf("Partida gravada em %s.\n", caminho);
+    else
+        printf("Não foi possível gravar %s.\n", caminho);
 }
 
-/* Libera a memória das missões dos jogadores (vetor de strings alocadas) e do mapa */
-void liberarMemoria(Territorio* mapa, int tamanho, char** missoesJogadores, int numJogadores) {
-    if (mapa) free(mapa);
-    if (missoesJogadores) {
-        for (int i = 0; i < numJogadores; ++i) {
-            if (missoesJogadores[i]) free(missoesJogadores[i]);
-        }
-        free(missoesJogadores);
-    }
+/* Lê uma linha do teclado; com métricas, o tempo de espera conta na fase de entrada. */
+static char* lerEntrada(char* input, int tamanho) {
+    METRICA_INICIO(inicio);
+    char* linha = fgets(input, tamanho, stdin);
+    METRICA_FIM(FASE_ENTRADA, inicio);
+    return linha;
 }
 
-/* Contadores auxiliares */
-int contarTerritoriosDoJogador(Territorio* mapa, int tamanho, const char* corJogador) {
-    int cnt = 0;
-    for (int i = 0; i < tamanho; ++i) {
-        if (strcmp(mapa[i].cor, corJogador) == 0) cnt++;
-    }
-    return cnt;
-}
-int somarTropasDoJogador(Territorio* mapa, int tamanho, const char* corJogador) {
-    int soma = 0;
-    for (int i = 0; i < tamanho; ++i) {
-        if (strcmp(mapa[i].cor, corJogador) == 0) soma += mapa[i].tropas;
-    }
-    return soma;
-}
-int existeTerritorioComNome(Territorio* mapa, int tamanho, const char* nome) {
-    for (int i = 0; i < tamanho; ++i) {
-        if (strcmp(mapa[i].nome, nome) == 0) return 1;
+/* Jogada de um assento do computador: escolhe pela busca em árvore
+   (war_mcts.h) e aplica como um ataque digitado. Retorna 1 se atacou. */
+static int jogadaDoComputador(JogadorMcts* mcts, EstadoJogo* estado, HistoricoJogo* historico,
+                              const Missao* missoes, const int* donos, int numJogadores, int jogadorAtual, int turno) {
+    int idxAtq, idxDef;
+    int ataca = escolherJogadaMcts(mcts, estado, missoes, donos, numJogadores, jogadorAtual, &idxAtq, &idxDef);
+    printf("Computador: %ld simulações em %.2f s.\n", mcts->iteracoes, mcts->segundos);
+    if (!ataca) {
+        printf("Jogador %d passou o turno.\n", jogadorAtual + 1);
+        registrarPasse(historico, turno);
+        return 0;
     }
-    return 0;
+    printf("Jogador %d ataca %s a partir de %s.\n", jogadorAtual + 1, nomeDoTerritorio(estado->mapa, idxDef),
+           nomeDoTerritorio(estado->mapa, idxAtq));
+    if (!atacarComHistorico(historico, estado, turno, idxAtq, idxDef))
+        printf("Sem memória para registrar o ataque.\n");
+    return 1;
 }
 
 /* ----------------------- Função main (demonstração) ----------------------- */
-int main() {
+/* Uso: ./nivel-mestre [partida] [-s semente] [-r historico [turnos]] [-b jogador] [-t segundos]
+   -r refaz os 'turnos' primeiros turnos (todos, se omitido) de um histórico
+   gravado pelo comando 'h' e continua a partida dali. Refeito o histórico
+   inteiro, os dados continuam como na partida gravada; refeito só o início,
+   os dados seguintes saem da semente e não repetem os da partida original.
+   -b entrega o jogador (1 ou 2, pode repetir) ao computador, que pensa
+   'segundos' por jogada (padrão 0,1). */
+int main(int argc, char** argv) {
     srand((unsigned int)time(NULL));
+    METRICAS_INSTALAR();
 
-    /* Definição de missões (cada string começa com um id e '|' para facilitar verificação) */
-    char* missoesDisponiveis[] = {
-        "1|Conquistar 3 territorios",                       // id 1
-        "2|Eliminar todas as tropas da cor Vermelho",       // id 2 (note: cor usada "Vermelho")
-        "3|Controlar todos os territorios",                 // id 3
-        "4|Ter ao menos 10 tropas no total",                // id 4
-        "5|Conquistar o territorio Fortaleza"               // id 5 (alvo: "Fortaleza")
-    };
-    int totalMissoes = sizeof(missoesDisponiveis) / sizeof(missoesDisponiveis[0]);
+    const char* caminhoJogo = NULL;
+    const char* caminhoHistorico = NULL;
+    int turnosReproduzidos = -1;
+    uint64_t semente = (uint64_t) time(NULL);
+    int computador[2] = {0, 0}; // assentos jogados pela busca em árvore
+    ConfigMcts cfgMcts = configMctsPadrao();
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            int assento = atoi(argv[++i]);
+            if (assento == 1 || assento == 2) computador[assento - 1] = 1;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            cfgMcts.segundosPorJogada = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            caminhoHistorico = argv[++i];
+            if (i + 1 < argc && isdigit((unsigned char) argv[i + 1][0])) turnosReproduzidos = atoi(argv[++i]);
+        } else {
+            caminhoJogo = argv[i];
+        }
+    }
 
-    /* Configuração do mapa: cria dinamicamente N territorios */
-    int numTerritorios = 6;
-    Territorio* mapa = (Territorio*) calloc(numTerritorios, sizeof(Territorio));
-    if (!mapa) {
-        perror("malloc mapa");
-        return 1;
+    /* Histórico de ações: o de um arquivo (-r) traz a semente e as missões da partida original */
+    HistoricoJogo historico = {0, NULL, 0, 0};
+    GeradorAleatorio geradorGravado; // estado do gerador da partida quando o histórico foi gravado
+    if (caminhoHistorico) {
+        if (!carregarHistorico(&historico, caminhoHistorico, &geradorGravado)) {
+            fprintf(stderr, "Não foi possível ler o histórico %s.\n", caminhoHistorico);
+            return 1;
+        }
+        semente = historico.semente;
     }
-    /* Inicializa nomes, cores e tropas - exemplo inicial */
-    strcpy(mapa[0].nome, "Fortaleza"); strcpy(mapa[0].cor, "Vermelho"); mapa[0].tropas = 3;
-    strcpy(mapa[1].nome, "Colina");     strcpy(mapa[1].cor, "Azul");     mapa[1].tropas = 2;
-    strcpy(mapa[2].nome, "Planalto");   strcpy(mapa[2].cor, "Vermelho"); mapa[2].tropas = 4;
-    strcpy(mapa[3].nome, "Vale");       strcpy(mapa[3].cor, "Verde");    mapa[3].tropas = 1;
-    strcpy(mapa[4].nome, "Costa");      strcpy(mapa[4].cor, "Azul");     mapa[4].tropas = 3;
-    strcpy(mapa[5].nome, "Pântano");    strcpy(mapa[5].cor, "Amarelo");  mapa[5].tropas = 2;
+    GeradorAleatorio geradorJogo; // dados e missões: a mesma semente repete a partida
+    geradorIniciar(&geradorJogo, semente);
 
-    /* Jogadores (exemplo com 2 jogadores): suas cores e missões alocadas dinamicamente */
+    /* Estado da partida numa única alocação (war_arena.h): os territórios, o mapa em
+       colunas e as missões dos jogadores. A capacidade é somada aqui, então as
+       reservas abaixo não falham; no fim (ou num erro) basta liberar a arena. */
+    int numTerritorios = NUM_TERRITORIOS_PADRAO;
     int numJogadores = 2;
-    const char* coresJogadores[] = {"Azul", "Verde"}; // cores dos jogadores
-    char** missoesJogadores = (char**) malloc(sizeof(char*) * numJogadores);
-    if (!missoesJogadores) {
-        perror("malloc missoesJogadores");
-        free(mapa);
+    ArenaJogo arena;
+    size_t bytesArena = bytesNaArena(sizeof(Territorio) * numTerritorios) +
+                        bytesNaArena(bytesDoMapa(numTerritorios, sizeof(((Territorio*) 0)->nome) * numTerritorios)) +
+                        bytesNaArena(sizeof(char*) * numJogadores) + numJogadores * bytesNaArena(MAX_MISSAO);
+    if (!criarArena(&arena, bytesArena)) {
+        perror("malloc arena");
+        liberarHistorico(&historico);
         return 1;
     }
-    for (int i = 0; i < numJogadores; ++i) {
-        missoesJogadores[i] = (char*) malloc(200 * sizeof(char)); // espaço para a string da missão
-        if (!missoesJogadores[i]) {
-            perror("malloc missao jogador");
-            // liberar já alocado
-            for (int j = 0; j < i; ++j) free(missoesJogadores[j]);
-            free(missoesJogadores);
-            free(mapa);
+    Territorio* mapa = (Territorio*) reservarNaArena(&arena, sizeof(Territorio) * numTerritorios);
+    /* Inicializa nomes, cores e tropas - exemplo inicial */
+    inicializarMapaPadrao(mapa);
+
+    /* Com um arquivo na linha de comando, continua uma partida gravada pelo comando 'g'
+       (ou começa uma nova sobre um cenário sem jogadores, gravado pelo simulador com -e) */
+    JogoSalvo salvo;
+    int carregado = 0;
+    if (caminhoJogo) {
+        if (!abrirJogoSalvo(&salvo, caminhoJogo) || (salvo.numJogadores != 0 && salvo.numJogadores != 2)) {
+            fprintf(stderr, "Não foi possível continuar a partida de %s.\n", caminhoJogo);
+            if (salvo.base) fecharJogoSalvo(&salvo);
+            liberarArena(&arena);
+            liberarHistorico(&historico);
             return 1;
         }
-        atribuirMissao(missoesJogadores[i], missoesDisponiveis, totalMissoes);
+        carregado = 1;
+    }
+    int retomado = carregado && salvo.numJogadores == 2;
+
+    /* Jogadores (exemplo com 2 jogadores): suas cores e missões, reservadas na arena */
+    const char* coresJogadores[] = {"Azul", "Verde"}; // cores dos jogadores
+    int donosJogadores[2];                              // ids das cores no registro
+    for (int i = 0; i < numJogadores; ++i)
+        donosJogadores[i] = retomado ? salvo.jogadores[i].dono : registrarCor(coresJogadores[i]);
+    char** missoesJogadores = (char**) reservarNaArena(&arena, sizeof(char*) * numJogadores);
+    for (int i = 0; i < numJogadores; ++i) {
+        missoesJogadores[i] = (char*) reservarNaArena(&arena, MAX_MISSAO); // espaço para a string da missão
+        const char* salva = missaoPorId(missaoNoHistorico(&historico, i));
+        if (!salva && retomado) salva = missaoPorId(salvo.jogadores[i].idMissao);
+        if (salva) strcpy(missoesJogadores[i], salva);
+        else atribuirMissaoComGerador(missoesJogadores[i], missoesDisponiveis, totalMissoesDisponiveis, &geradorJogo);
     }
 
     /* Exibe missão apenas uma vez no início para cada jogador (interface intuitiva) */
+    printf("Semente da partida: %llu\n", (unsigned long long) semente);
     printf("=== Missões atribuídas (exibidas uma vez) ===\n");
     for (int i = 0; i < numJogadores; ++i) {
         printf("Jogador %d (cor %s): ", i+1, coresJogadores[i]);
@@ -243,53 +222,237 @@ int main() {
     /* Loop de turnos simplificado: cada jogador pode atacar até que alguém cumpra a missão.
        A cada final de turno, verifica-se silenciosamente se a missão foi cumprida. */
     int vencedor = -1;
-    int turno = 0;
+    int turno = carregado ? salvo.turno : 0;
     char input[100];
+    Mapa colunas;    // o jogo roda sobre o mapa em colunas (dono e tropas contíguos)
+    GrafoMapa grafo; // fronteiras: só é possível atacar um território vizinho
+    int grafoProprio = 1; // as fronteiras de uma partida gravada ficam no arquivo mapeado
+    if (carregado) {
+        colunas = salvo.mapa; // bloco == NULL: liberarMapa não libera nada
+        grafoProprio = !salvo.temGrafo;
+        if (salvo.temGrafo) grafo = salvo.grafo;
+    } else {
+        criarMapaDeTerritorios(&colunas, mapa, numTerritorios, &arena); // bloco na arena: liberarMapa não libera nada
+    }
+    numTerritorios = colunas.tamanho;
+    if (grafoProprio && !(carregado ? criarGrafoGrade(&grafo, numTerritorios) : criarGrafoPadrao(&grafo))) {
+        perror("malloc grafo");
+        liberarMapa(&colunas);
+        if (carregado) fecharJogoSalvo(&salvo);
+        liberarArena(&arena);
+        liberarHistorico(&historico);
+        return 1;
+    }
+    EstadoJogo estado; // mantém contadores por cor atualizados a cada ataque
+    iniciarEstadoJogo(&estado, &colunas, &grafo, &geradorJogo);
+    Missao missoesCompiladas[2]; // missões interpretadas uma vez, verificadas a cada turno
+    for (int i = 0; i < numJogadores; ++i) compilarMissao(&missoesCompiladas[i], missoesJogadores[i], &estado);
+    ConselheiroAtaque conselheiro; // chances memoizadas para o comando 'o'
+    GeradorAleatorio geradorConselheiro;
+    geradorIniciar(&geradorConselheiro, (uint64_t) time(NULL));
+    int historicoOk = caminhoHistorico || criarHistorico(&historico, semente);
+    if (!historicoOk || !criarConselheiro(&conselheiro, 0)) {
+        perror(historicoOk ? "malloc conselheiro" : "malloc historico");
+        if (grafoProprio) liberarGrafo(&grafo);
+        liberarMapa(&colunas);
+        if (carregado) fecharJogoSalvo(&salvo);
+        liberarArena(&arena);
+        liberarHistorico(&historico);
+        return 1;
+    }
+    int historicoInteiro = 0; // todas as ações refeitas: o gerador volta ao estado gravado
+    if (caminhoHistorico) {
+        // refaz as ações gravadas sobre o mapa inicial e continua dali (o resto do histórico é
+        // descartado, menos as missões)
+        int gravadas = historico.total;
+        int refeitas = reproduzirHistorico(&historico, &estado, turnosReproduzidos);
+        if (refeitas < 0) {
+            fprintf(stderr, "O histórico %s não é deste mapa.\n", caminhoHistorico);
+            liberarConselheiro(&conselheiro);
+            if (grafoProprio) liberarGrafo(&grafo);
+            liberarMapa(&colunas);
+            if (carregado) fecharJogoSalvo(&salvo);
+            liberarArena(&arena);
+            liberarHistorico(&historico);
+            return 1;
+        }
+        historicoInteiro = refeitas == gravadas;
+        if (turnosReproduzidos >= 0) {
+            turno += turnosReproduzidos;
+        } else {
+            // turno seguinte ao da última jogada refeita (as missões não contam)
+            for (int i = refeitas - 1; i >= 0; --i) {
+                if (historico.acoes[i].tipo != ACAO_MISSAO) {
+                    turno = historico.acoes[i].turno + 1;
+                    break;
+                }
+            }
+        }
+        if (!historicoInteiro) cortarHistorico(&historico, refeitas);
+        printf("Histórico: %d ações refeitas, continuando no turno %d.\n", refeitas, turno + 1);
+        printf(historicoInteiro ? "Os dados seguem de onde a partida gravada parou.\n\n"
+                                : "Histórico parcial: os dados seguintes não repetem os da partida gravada.\n\n");
+    } else {
+        for (int i = 0; i < numJogadores; ++i) registrarMissao(&historico, turno, i, idDaMissao(missoesJogadores[i]));
+    }
+    JogadorMcts mcts; // assentos do computador (-b)
+    int usaComputador = computador[0] || computador[1];
+    if (usaComputador && !criarJogadorMcts(&mcts, &cfgMcts, &estado, geradorProximo(&geradorJogo))) {
+        perror("malloc jogador do computador");
+        usaComputador = computador[0] = computador[1] = 0;
+    }
+    // depois da semente do computador, que a partida gravada também já tinha tirado
+    if (historicoInteiro) geradorJogo = geradorGravado;
+    int passesSeguidos = 0; // só encerra a partida quando os dois assentos são do computador
+
+    DiarioEventos diario; // mensagens de batalha: texto no console, descarregado a cada ação
+    abrirDiarioEventos(&diario, stdout, FORMATO_EVENTOS_TEXTO, NIVEL_EVENTOS_BATALHA);
+    usarDiarioEventos(&diario);
+
+    TelaMapa tela; // uma página do mapa; a cada turno só as linhas alteradas são reescritas
+    int ansi = telaSuportaAnsi(stdout);
+    int telaOk = criarTelaMapa(&tela, &colunas, stdout,
+                               ansi ? linhasPorPaginaDoTerminal(stdout) : LINHAS_POR_PAGINA_PADRAO, ansi);
+    if (telaOk && ansi && !(computador[0] && computador[1])) {
+        // o primeiro quadro limpa a tela: dá tempo de ler a missão
+        printf("Pressione Enter para começar...");
+        lerEntrada(input, sizeof(input));
+    }
 
     while (1) {
         int jogadorAtual = turno % numJogadores;
+        diario.turno = turno;
+        {
+            // o mapa vem antes do cabeçalho: um quadro completo limpa a tela
+            METRICA_INICIO(inicio);
+            if (telaOk) desenharTela(&tela);
+            else exibirMapaColunar(&colunas);
+            METRICA_FIM(FASE_DESENHO, inicio);
+        }
         printf("=== Turno do Jogador %d (cor %s) ===\n", jogadorAtual + 1, coresJogadores[jogadorAtual]);
-        exibirMapa(mapa, numTerritorios);
 
-        // interação: jogador escolhe atacar (entre índices) ou passar
-        printf("Digite o índice do território atacante (ou -1 para passar / s para sair): ");
-        if (!fgets(input, sizeof(input), stdin)) break;
-        if (input[0] == 's' || input[0] == 'S') break;
-        int idxAtq = atoi(input);
-        if (idxAtq == -1) {
-            printf("Jogador %d passou o turno.\n", jogadorAtual + 1);
-        } else if (idxAtq < 0 || idxAtq >= numTerritorios) {
-            printf("Índice inválido.\n");
+        if (computador[jogadorAtual]) {
+            METRICA_INICIO(inicio);
+            if (jogadaDoComputador(&mcts, &estado, &historico, missoesCompiladas, donosJogadores, numJogadores,
+                                   jogadorAtual, turno)) passesSeguidos = 0;
+            else passesSeguidos++;
+            METRICA_FIM(FASE_ATAQUE, inicio);
+            descarregarEventos(&diario);
         } else {
-            // verifica se jogador é dono do território atacante
-            if (strcmp(mapa[idxAtq].cor, coresJogadores[jogadorAtual]) != 0) {
-                printf("Você só pode atacar de territórios de sua cor.\n");
+            // interação: jogador escolhe atacar (entre índices) ou passar
+            printf("Digite o índice do território atacante (ou -1 para passar / o para chances / g para gravar / "
+                   "u para desfazer / h para gravar o histórico / p [n] para a página n do mapa / s para sair): ");
+            if (!lerEntrada(input, sizeof(input))) break;
+            if (input[0] == 's' || input[0] == 'S') break;
+            if (input[0] == 'g' || input[0] == 'G') {
+                printf("Nome do arquivo: ");
+                if (!lerEntrada(input, sizeof(input))) break;
+                gravarPartida(&colunas, &grafo, donosJogadores, missoesJogadores, numJogadores, turno, input);
+                printf("\n");
+                continue; // gravar não gasta o turno
+            }
+            if (input[0] == 'u' || input[0] == 'U') {
+                int turnoDesfeito = desfazerAcao(&historico, &estado);
+                if (turnoDesfeito < 0) {
+                    printf("Não há ação para desfazer.\n\n");
+                } else {
+                    printf("Ação do turno %d desfeita.\n\n", turnoDesfeito + 1);
+                    turno = turnoDesfeito; // volta para o turno da ação desfeita
+                }
+                continue;
+            }
+            if (input[0] == 'h' || input[0] == 'H') {
+                char caminho[100];
+                printf("Nome do arquivo: ");
+                if (!lerEntrada(input, sizeof(input))) break;
+                if (sscanf(input, "%99s", caminho) != 1) printf("Informe o nome do arquivo.\n");
+                else if (salvarHistorico(caminho, &historico, &geradorJogo)) printf("Histórico gravado em %s.\n", caminho);
+                else printf("Não foi possível gravar %s.\n", caminho);
+                printf("\n");
+                continue; // gravar não gasta o turno
+            }
+            if (input[0] == 'p' || input[0] == 'P') {
+                // sem número, a próxima página; o quadro seguinte é completo mesmo na página atual
+                int pagina;
+                if (telaOk) {
+                    mudarPaginaTela(&tela, sscanf(input + 1, "%d", &pagina) == 1 ? pagina - 1 : tela.pagina + 1);
+                    invalidarTela(&tela);
+                }
+                continue; // mudar de página não gasta o turno
+            }
+            if (input[0] == 'o' || input[0] == 'O') {
+                printf("Atacante e alvos em cadeia (ex.: 0 2 3): ");
+                if (!lerEntrada(input, sizeof(input))) break;
+                exibirChances(&estado, &conselheiro, &geradorConselheiro, input);
+                printf("\n");
+                continue; // consultar as chances não gasta o turno
+            }
+            int idxAtq = atoi(input);
+            if (idxAtq == -1) {
+                printf("Jogador %d passou o turno.\n", jogadorAtual + 1);
+                registrarPasse(&historico, turno);
+            } else if (idxAtq < 0 || idxAtq >= numTerritorios) {
+                printf("Índice inválido.\n");
+                METRICA_CONTAR(CONTADOR_ATAQUES_TENTADOS);
+                METRICA_CONTAR(CONTADOR_ATAQUES_REJEITADOS);
             } else {
-                printf("Digite o índice do território defensor: ");
-                if (!fgets(input, sizeof(input), stdin)) break;
-                int idxDef = atoi(input);
-                if (idxDef < 0 || idxDef >= numTerritorios) {
-                    printf("Índice inválido.\n");
-                } else if (idxDef == idxAtq) {
-                    printf("Não pode atacar o mesmo território.\n");
+                // verifica se jogador é dono do território atacante
+                if (colunas.dono[idxAtq] != donosJogadores[jogadorAtual]) {
+                    printf("Você só pode atacar de territórios de sua cor.\n");
+                    METRICA_CONTAR(CONTADOR_ATAQUES_TENTADOS);
+                    METRICA_CONTAR(CONTADOR_ATAQUES_REJEITADOS);
                 } else {
-                    // valida que defensor é de cor diferente
-                    if (strcmp(mapa[idxDef].cor, mapa[idxAtq].cor) == 0) {
-                        printf("O defensor pertence ao mesmo jogador. Escolha outro alvo.\n");
+                    printf("Fronteiras de %s:", nomeDoTerritorio(&colunas, idxAtq));
+                    for (int k = grafo.inicio[idxAtq]; k < grafo.inicio[idxAtq + 1]; ++k) {
+                        printf(" %d (%s)", grafo.vizinhos[k], nomeDoTerritorio(&colunas, grafo.vizinhos[k]));
+                    }
+                    printf("\n");
+                    printf("Digite o índice do território defensor: ");
+                    if (!lerEntrada(input, sizeof(input))) break;
+                    int idxDef = atoi(input);
+                    // recusas da interface não chegam ao motor: contam aqui como tentadas e rejeitadas
+                    int recusado = 1;
+                    if (idxDef < 0 || idxDef >= numTerritorios) {
+                        printf("Índice inválido.\n");
+                    } else if (idxDef == idxAtq) {
+                        printf("Não pode atacar o mesmo território.\n");
+                    } else if (!fazemFronteira(&estado, idxAtq, idxDef)) {
+                        printf("%s não faz fronteira com %s.\n", nomeDoTerritorio(&colunas, idxDef),
+                               nomeDoTerritorio(&colunas, idxAtq));
                     } else {
-                        atacar(&mapa[idxAtq], &mapa[idxDef]);
+                        // valida que defensor é de cor diferente
+                        if (colunas.dono[idxDef] == colunas.dono[idxAtq]) {
+                            printf("O defensor pertence ao mesmo jogador. Escolha outro alvo.\n");
+                        } else {
+                            recusado = 0;
+                            METRICA_INICIO(inicio);
+                            if (!atacarComHistorico(&historico, &estado, turno, idxAtq, idxDef))
+                                printf("Sem memória para registrar o ataque.\n");
+                            descarregarEventos(&diario);
+                            METRICA_FIM(FASE_ATAQUE, inicio);
+                        }
+                    }
+                    if (recusado) {
+                        METRICA_CONTAR(CONTADOR_ATAQUES_TENTADOS);
+                        METRICA_CONTAR(CONTADOR_ATAQUES_REJEITADOS);
                     }
                 }
             }
         }
 
         // Ao final do turno, verificar silenciosamente se missão foi cumprida
+        METRICA_INICIO(inicioMissao);
         for (int j = 0; j < numJogadores; ++j) {
-            if (verificarMissao(missoesJogadores[j], mapa, numTerritorios, coresJogadores[j])) {
+            if (verificarMissaoNoEstado(&missoesCompiladas[j], &estado, donosJogadores[j])) {
+                Evento e = {EVENTO_MISSAO_CUMPRIDA, -1, -1, NULL, NULL, donosJogadores[j], -1, 0, 0, 0, 0,
+                            missoesCompiladas[j].id};
+                emitirEvento(&e);
+                descarregarEventos(&diario);
                 vencedor = j;
                 break;
             }
         }
+        METRICA_FIM(FASE_MISSAO, inicioMissao);
         if (vencedor != -1) {
             printf("\n=== Missão cumprida! ===\n");
             printf("Jogador %d (cor %s) cumpriu sua missão: ", vencedor + 1, coresJogadores[vencedor]);
@@ -297,12 +460,25 @@ int main() {
             break;
         }
 
+        if (computador[0] && computador[1] && passesSeguidos >= numJogadores) {
+            printf("\nNenhum jogador ataca mais: empate.\n");
+            break;
+        }
+
         turno++;
         printf("\n");
     }
 
     /* Limpeza e fim */
-    liberarMemoria(mapa, numTerritorios, missoesJogadores, numJogadores);
+    fecharDiarioEventos(&diario);
+    if (telaOk) liberarTelaMapa(&tela);
+    if (usaComputador) liberarJogadorMcts(&mcts);
+    liberarHistorico(&historico);
+    liberarConselheiro(&conselheiro);
+    if (grafoProprio) liberarGrafo(&grafo);
+    liberarMapa(&colunas);
+    if (carregado) fecharJogoSalvo(&salvo);
+    liberarArena(&arena);
     printf("Jogo finalizado. Memória liberada.\n");
     return 0;
 }
@@ -0,0 +1,172 @@
+/* teste_arquivo.c
+   Confere que abrirJogoSalvo recusa um jogo salvo corrompido: grava o mapa
+   de demonstração com as fronteiras, abre o original e depois cópias com um
+   único valor trocado (dono de território, dono de jogador, início de nome e
+   vizinho), que precisam falhar em vez de ler fora dos vetores. Faz o mesmo
+   com um histórico (tipo de ação, tropas, dono e território trocados), que
+   precisa ser recusado pela leitura ou pela reprodução, e confere que cortar
+   o histórico mantém as missões.
+
+   Uso: make teste
+*/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "war_arquivo.h"
+#include "war_historico.h"
+
+#define ARQUIVO_TESTE "teste_arquivo.warsave"
+#define HISTORICO_TESTE "teste_arquivo.hist"
+
+static int falhas = 0;
+
+/* Troca os 'bytes' bytes na posição 'posicao' do arquivo por 'valor'. */
+static void corromperBytes(const char* caminho, uint64_t posicao, const void* valor, size_t bytes) {
+    FILE* f = fopen(caminho, "r+b");
+    if (!f || fseek(f, (long) posicao, SEEK_SET) != 0 || fwrite(valor, bytes, 1, f) != 1) {
+        fprintf(stderr, "não foi possível alterar %s\n", caminho);
+        falhas++;
+    }
+    if (f) fclose(f);
+}
+
+static void corromper(const char* caminho, uint64_t posicao, int32_t valor) {
+    corromperBytes(caminho, posicao, &valor, sizeof(valor));
+}
+
+static void conferir(const char* descricao, int esperado) {
+    JogoSalvo jogo;
+    int aberto = abrirJogoSalvo(&jogo, ARQUIVO_TESTE);
+    if (aberto) fecharJogoSalvo(&jogo);
+    printf("%-36s %s\n", descricao, aberto == esperado ? "ok" : "FALHOU");
+    if (aberto != esperado) falhas++;
+}
+
+/* Lê o histórico gravado e o reproduz sobre 'estado'; 1 se os dois deram certo. */
+static int historicoAceito(EstadoJogo* estado) {
+    HistoricoJogo h;
+    GeradorAleatorio g;
+    if (!carregarHistorico(&h, HISTORICO_TESTE, &g)) return 0;
+    int refeitas = reproduzirHistorico(&h, estado, -1);
+    liberarHistorico(&h);
+    return refeitas >= 0;
+}
+
+static void conferirHistorico(const char* descricao, EstadoJogo* estado, int esperado) {
+    int aceito = historicoAceito(estado);
+    printf("%-36s %s\n", descricao, aceito == esperado ? "ok" : "FALHOU");
+    if (aceito != esperado) falhas++;
+}
+
+/* Um histórico com um ataque em cada um dos turnos 0 e 1, a missão do
+   primeiro jogador no turno 0 e a do segundo registrada depois do ataque do
+   turno 1, para que o corte no turno 1 precise trazê-la de trás. */
+static void testarHistorico(Mapa* mapa, const GrafoMapa* grafo) {
+    GeradorAleatorio gerador;
+    geradorIniciar(&gerador, 7);
+    EstadoJogo estado;
+    iniciarEstadoJogo(&estado, mapa, grafo, &gerador);
+    HistoricoJogo h;
+    if (!criarHistorico(&h, 7)) {
+        fprintf(stderr, "sem memória\n");
+        falhas++;
+        return;
+    }
+    registrarMissao(&h, 0, 0, 1);
+    atacarComHistorico(&h, &estado, 0, 2, 1);
+    atacarComHistorico(&h, &estado, 1, 4, 3);
+    registrarMissao(&h, 1, 1, 2);
+    int ok = salvarHistorico(HISTORICO_TESTE, &h, &gerador);
+    conferirHistorico("histórico íntegro", &estado, 1);
+
+    // o ataque do turno 1 é a terceira ação do arquivo
+    uint64_t ataque = sizeof(CabecalhoHistorico) + sizeof(AcaoHistorico) * 2;
+    uint8_t tipo = 9, dono = (uint8_t) registroCores.total, donoForaDosAgregados = 200;
+    struct {
+        const char* descricao;
+        uint64_t posicao;
+        const void* valor;
+        size_t bytes;
+    } casos[] = {
+        {"ação de tipo desconhecido", ataque + offsetof(AcaoHistorico, tipo), &tipo, 1},
+        {"dono fora dos agregados", ataque + offsetof(AcaoHistorico, donoDefensorDepois), &donoForaDosAgregados, 1},
+        {"dono fora do registro de cores", ataque + offsetof(AcaoHistorico, donoDefensorAntes), &dono, 1},
+        {"tropas negativas", ataque + offsetof(AcaoHistorico, tropasDefensorDepois), &(int32_t) {-3}, 4},
+        {"defensor fora do mapa", ataque + offsetof(AcaoHistorico, defensor), &mapa->tamanho, 4},
+    };
+    for (size_t k = 0; ok && k < sizeof(casos) / sizeof(casos[0]); ++k) {
+        salvarHistorico(HISTORICO_TESTE, &h, &gerador);
+        corromperBytes(HISTORICO_TESTE, casos[k].posicao, casos[k].valor, casos[k].bytes);
+        conferirHistorico(casos[k].descricao, &estado, 0);
+    }
+    if (!ok) {
+        fprintf(stderr, "não foi possível gravar %s\n", HISTORICO_TESTE);
+        falhas++;
+    }
+
+    // reprodução parcial (só o turno 0) seguida do corte: as duas missões ficam
+    int refeitas = reproduzirHistorico(&h, &estado, 1);
+    cortarHistorico(&h, refeitas);
+    int missoes = missaoNoHistorico(&h, 0) == 1 && missaoNoHistorico(&h, 1) == 2 && h.total == 3;
+    printf("%-36s %s\n", "missões mantidas no corte", missoes ? "ok" : "FALHOU");
+    if (!missoes) falhas++;
+    refeitas = reproduzirHistorico(&h, &estado, 0);
+    cortarHistorico(&h, refeitas);
+    missoes = missaoNoHistorico(&h, 0) == 1 && missaoNoHistorico(&h, 1) == 2 && h.total == 2;
+    printf("%-36s %s\n", "missões mantidas no corte do turno 0", missoes ? "ok" : "FALHOU");
+    if (!missoes) falhas++;
+
+    remove(HISTORICO_TESTE);
+    liberarHistorico(&h);
+}
+
+int main(void) {
+    Territorio territorios[NUM_TERRITORIOS_PADRAO];
+    inicializarMapaPadrao(territorios);
+    Mapa mapa;
+    GrafoMapa grafo;
+    if (!criarMapaDeTerritorios(&mapa, territorios, NUM_TERRITORIOS_PADRAO, NULL) || !criarGrafoPadrao(&grafo)) {
+        fprintf(stderr, "sem memória\n");
+        return 1;
+    }
+    JogadorSalvo jogadores[2] = {{mapa.dono[0], 1}, {mapa.dono[1], 2}};
+
+    // posições das seções, lidas do cabeçalho do arquivo gravado
+    CabecalhoJogoSalvo c;
+    FILE* f;
+    if (!salvarJogo(ARQUIVO_TESTE, &mapa, &grafo, jogadores, 2, 0) || !(f = fopen(ARQUIVO_TESTE, "rb")) ||
+        fread(&c, sizeof(c), 1, f) != 1) {
+        fprintf(stderr, "não foi possível gravar %s\n", ARQUIVO_TESTE);
+        return 1;
+    }
+    fclose(f);
+    conferir("arquivo íntegro", 1);
+
+    struct {
+        const char* descricao;
+        uint64_t posicao;
+        int32_t valor;
+    } casos[] = {
+        {"dono de território fora das cores", c.secaoDono + sizeof(int32_t) * 2, c.numCores},
+        {"dono de território negativo", c.secaoDono, -1},
+        {"dono de jogador fora das cores", c.secaoJogadores + offsetof(JogadorSalvo, dono), 99},
+        {"início de nome decrescente", c.secaoInicioNome + sizeof(int32_t) * 3, 0x7fffffff},
+        {"início do grafo decrescente", c.secaoInicioGrafo + sizeof(int32_t) * 2, -5},
+        {"vizinho fora do mapa", c.secaoVizinhos + sizeof(int32_t), c.numTerritorios},
+        {"vizinho negativo", c.secaoVizinhos, -1},
+    };
+    for (size_t k = 0; k < sizeof(casos) / sizeof(casos[0]); ++k) {
+        salvarJogo(ARQUIVO_TESTE, &mapa, &grafo, jogadores, 2, 0);
+        corromper(ARQUIVO_TESTE, casos[k].posicao, casos[k].valor);
+        conferir(casos[k].descricao, 0);
+    }
+
+    remove(ARQUIVO_TESTE);
+    testarHistorico(&mapa, &grafo);
+    liberarGrafo(&grafo);
+    liberarMapa(&mapa);
+    if (falhas) printf("%d falha(s)\n", falhas);
+    return falhas != 0;
+}
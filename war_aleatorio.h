@@ -0,0 +1,79 @@
+/* war_aleatorio.h
+   Gerador pseudoaleatório xoshiro256** com estado próprio.
+   Diferente de rand()/srand(), cada gerador é independente: cada thread do
+   simulador usa o seu, e a mesma semente sempre reproduz a mesma sequência.
+   geradorSaltar() avança 2^128 posições, separando fluxos que nunca se sobrepõem.
+*/
+
+#ifndef WAR_ALEATORIO_H
+#define WAR_ALEATORIO_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t s[4];
+} GeradorAleatorio;
+
+static inline uint64_t rotacionar64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/* splitmix64: espalha uma semente qualquer pelos 256 bits de estado. */
+static inline uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline void geradorIniciar(GeradorAleatorio* g, uint64_t semente) {
+    for (int i = 0; i < 4; ++i) g->s[i] = splitmix64(&semente);
+}
+
+static inline uint64_t geradorProximo(GeradorAleatorio* g) {
+    uint64_t* s = g->s;
+    uint64_t resultado = rotacionar64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotacionar64(s[3], 45);
+    return resultado;
+}
+
+/* Avança o gerador 2^128 posições (equivale a 2^128 chamadas de geradorProximo). */
+static inline void geradorSaltar(GeradorAleatorio* g) {
+    static const uint64_t SALTO[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                     0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 64; ++b) {
+            if (SALTO[i] & (1ULL << b)) {
+                s0 ^= g->s[0]; s1 ^= g->s[1]; s2 ^= g->s[2]; s3 ^= g->s[3];
+            }
+            geradorProximo(g);
+        }
+    }
+    g->s[0] = s0; g->s[1] = s1; g->s[2] = s2; g->s[3] = s3;
+}
+
+/* Inteiro em [0, n) sem viés, pelo método de multiplicação de Lemire: o
+   produto de 32 x 32 bits é rejeitado (raramente) quando cairia na faixa que
+   favoreceria alguns valores, ao contrário de rand() % n. */
+static inline int geradorIntervalo(GeradorAleatorio* g, int n) {
+    uint32_t limite = (uint32_t) n;
+    uint64_t m = (geradorProximo(g) >> 32) * limite;
+    uint32_t resto = (uint32_t) m;
+    if (resto < limite) {
+        uint32_t corte = (0u - limite) % limite;
+        while (resto < corte) {
+            m = (geradorProximo(g) >> 32) * limite;
+            resto = (uint32_t) m;
+        }
+    }
+    return (int) (m >> 32);
+}
+
+#endif
@@ -0,0 +1,37 @@
+/* war_arena.c
+   Reserva e liberação da arena de uma partida.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "war_arena.h"
+#include "war_metricas.h"
+
+int criarArena(ArenaJogo* arena, size_t capacidade) {
+    arena->usados = 0;
+    arena->capacidade = bytesNaArena(capacidade > 0 ? capacidade : 1);
+    METRICA_CONTAR(CONTADOR_ALOCACOES);
+    arena->base = (unsigned char*) aligned_alloc(ALINHAMENTO_ARENA, arena->capacidade);
+    if (!arena->base) {
+        arena->capacidade = 0;
+        return 0;
+    }
+    return 1;
+}
+
+void liberarArena(ArenaJogo* arena) {
+    free(arena->base);
+    arena->base = NULL;
+    arena->usados = arena->capacidade = 0;
+}
+
+/* Retorna NULL se a arena não comporta a reserva (ela continua válida). */
+void* reservarNaArena(ArenaJogo* arena, size_t bytes) {
+    size_t ocupados = bytesNaArena(bytes > 0 ? bytes : 1);
+    if (ocupados > arena->capacidade - arena->usados) return NULL;
+    unsigned char* p = arena->base + arena->usados;
+    arena->usados += ocupados;
+    memset(p, 0, ocupados);
+    return p;
+}
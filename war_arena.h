@@ -0,0 +1,47 @@
+/* war_arena.h
+   Arena de uma partida: um único bloco reservado no início, de onde saem o
+   mapa, as missões e os vetores auxiliares, em vez de uma alocação para
+   cada um. Cada reserva só avança um deslocamento; não há free individual.
+
+   Liberar a partida é um free do bloco, e recomeçar é voltar o deslocamento
+   (zerarArena, ou voltarArena até uma marca tomada antes). As reservas são
+   alinhadas a ALINHAMENTO_ARENA bytes e vêm zeradas, como de calloc.
+*/
+
+#ifndef WAR_ARENA_H
+#define WAR_ARENA_H
+
+#include <stddef.h>
+
+#define ALINHAMENTO_ARENA 16
+
+typedef struct {
+    unsigned char* base;
+    size_t usados;
+    size_t capacidade;
+} ArenaJogo;
+
+int criarArena(ArenaJogo* arena, size_t capacidade);
+void liberarArena(ArenaJogo* arena);
+void* reservarNaArena(ArenaJogo* arena, size_t bytes);
+
+/* Bytes que uma reserva de 'bytes' ocupa na arena (com o alinhamento), para
+   somar a capacidade antes de criar a arena. */
+static inline size_t bytesNaArena(size_t bytes) {
+    return (bytes + ALINHAMENTO_ARENA - 1) & ~(size_t) (ALINHAMENTO_ARENA - 1);
+}
+
+static inline size_t marcaArena(const ArenaJogo* arena) {
+    return arena->usados;
+}
+
+/* Descarta tudo o que foi reservado depois de 'marca'. */
+static inline void voltarArena(ArenaJogo* arena, size_t marca) {
+    arena->usados = marca;
+}
+
+static inline void zerarArena(ArenaJogo* arena) {
+    arena->usados = 0;
+}
+
+#endif
@@ -0,0 +1,229 @@
+/* war_arquivo.c
+   Gravação e abertura (via mmap) do jogo salvo.
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "war_arquivo.h"
+
+#define ALINHAMENTO_SECAO 64
+
+_Static_assert(sizeof(int) == sizeof(int32_t), "o Mapa guarda int de 32 bits direto no arquivo");
+
+static uint64_t alinharSecao(uint64_t posicao) {
+    return (posicao + ALINHAMENTO_SECAO - 1) & ~(uint64_t) (ALINHAMENTO_SECAO - 1);
+}
+
+/* Escreve 'bytes' de 'dados' na posição 'secao', completando com zeros o
+   espaço entre o fim da seção anterior e ela. */
+static int gravarSecao(FILE* f, uint64_t* escrito, uint64_t secao, const void* dados, size_t bytes) {
+    static const char zeros[ALINHAMENTO_SECAO] = {0};
+    if (secao == 0) return 1;
+    while (*escrito < secao) {
+        size_t n = secao - *escrito < sizeof(zeros) ? (size_t) (secao - *escrito) : sizeof(zeros);
+        if (fwrite(zeros, 1, n, f) != n) return 0;
+        *escrito += n;
+    }
+    if (bytes > 0 && fwrite(dados, 1, bytes, f) != bytes) return 0;
+    *escrito += bytes;
+    return 1;
+}
+
+/* Grava o mapa (todos os nomes precisam estar definidos), as fronteiras se
+   'grafo' não for NULL, os jogadores e o turno. Retorna 0 em caso de erro. */
+int salvarJogo(const char* caminho, const Mapa* mapa, const GrafoMapa* grafo,
+               const JogadorSalvo* jogadores, int numJogadores, int turno) {
+    int n = mapa->tamanho;
+    if (mapa->nomesDefinidos != n || numJogadores < 0 || numJogadores > MAX_JOGADORES_SALVOS) return 0;
+    if (grafo && grafo->numTerritorios != n) return 0;
+
+    CabecalhoJogoSalvo c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.magica, MAGICA_JOGO_SALVO, sizeof(MAGICA_JOGO_SALVO));
+    c.versao = VERSAO_JOGO_SALVO;
+    c.bytesCabecalho = sizeof(c);
+    c.numTerritorios = n;
+    c.numCores = registroCores.total;
+    c.numJogadores = numJogadores;
+    c.turno = turno;
+    c.numVizinhos = grafo ? grafo->inicio[n] : 0;
+    c.bytesNomes = n > 0 ? (uint64_t) mapa->inicioNome[n] : 0;
+
+    uint64_t bytesInicio = sizeof(int32_t) * ((uint64_t) n + 1);
+    uint64_t pos = alinharSecao(sizeof(c));
+    c.secaoCores = pos;       pos = alinharSecao(pos + (uint64_t) c.numCores * MAX_COR);
+    c.secaoJogadores = pos;   pos = alinharSecao(pos + sizeof(JogadorSalvo) * (uint64_t) numJogadores);
+    c.secaoDono = pos;        pos = alinharSecao(pos + sizeof(int32_t) * (uint64_t) n);
+    c.secaoTropas = pos;      pos = alinharSecao(pos + sizeof(int32_t) * (uint64_t) n);
+    c.secaoInicioNome = pos;  pos = alinharSecao(pos + bytesInicio);
+    c.secaoNomes = pos;       pos += c.bytesNomes + 1;
+    if (grafo) {
+        pos = alinharSecao(pos);
+        c.secaoInicioGrafo = pos; pos = alinharSecao(pos + bytesInicio);
+        c.secaoVizinhos = pos;    pos += sizeof(int32_t) * (uint64_t) c.numVizinhos;
+    }
+    c.bytesArquivo = pos;
+
+    FILE* f = fopen(caminho, "wb");
+    if (!f) return 0;
+    uint64_t escrito = 0;
+    int ok = fwrite(&c, sizeof(c), 1, f) == 1;
+    escrito = sizeof(c);
+    ok = ok && gravarSecao(f, &escrito, c.secaoCores, registroCores.nomes, (size_t) c.numCores * MAX_COR);
+    ok = ok && gravarSecao(f, &escrito, c.secaoJogadores, jogadores, sizeof(JogadorSalvo) * numJogadores);
+    ok = ok && gravarSecao(f, &escrito, c.secaoDono, mapa->dono, sizeof(int32_t) * n);
+    ok = ok && gravarSecao(f, &escrito, c.secaoTropas, mapa->tropas, sizeof(int32_t) * n);
+    ok = ok && gravarSecao(f, &escrito, c.secaoInicioNome, mapa->inicioNome, (size_t) bytesInicio);
+    ok = ok && gravarSecao(f, &escrito, c.secaoNomes, mapa->nomes, (size_t) c.bytesNomes);
+    ok = ok && gravarSecao(f, &escrito, escrito, "", 1); // '\0' extra: nomes ainda não definidos apontam para ele
+    if (grafo) {
+        ok = ok && gravarSecao(f, &escrito, c.secaoInicioGrafo, grafo->inicio, (size_t) bytesInicio);
+        ok = ok && gravarSecao(f, &escrito, c.secaoVizinhos, grafo->vizinhos, sizeof(int32_t) * c.numVizinhos);
+    }
+    if (fclose(f) != 0) ok = 0;
+    return ok;
+}
+
+/* Confere que a seção [posicao, posicao + bytes) cabe no arquivo e está alinhada. */
+static int secaoValida(const CabecalhoJogoSalvo* c, uint64_t posicao, uint64_t bytes) {
+    return posicao >= sizeof(*c) && posicao % sizeof(int32_t) == 0 && posicao <= c->bytesArquivo &&
+           bytes <= c->bytesArquivo - posicao;
+}
+
+static int cabecalhoValido(const CabecalhoJogoSalvo* c, size_t bytesArquivo) {
+    if (memcmp(c->magica, MAGICA_JOGO_SALVO, sizeof(MAGICA_JOGO_SALVO)) != 0) return 0;
+    if (c->versao != VERSAO_JOGO_SALVO || c->bytesCabecalho != sizeof(*c) || c->bytesArquivo != bytesArquivo) return 0;
+    if (c->numTerritorios < 0 || c->numCores < 0 || c->numCores > MAX_CORES || c->numVizinhos < 0 ||
+        c->numJogadores < 0 || c->numJogadores > MAX_JOGADORES_SALVOS)
+        return 0;
+    uint64_t n = (uint64_t) c->numTerritorios;
+    if (!secaoValida(c, c->secaoCores, (uint64_t) c->numCores * MAX_COR) ||
+        !secaoValida(c, c->secaoJogadores, sizeof(JogadorSalvo) * (uint64_t) c->numJogadores) ||
+        !secaoValida(c, c->secaoDono, sizeof(int32_t) * n) ||
+        !secaoValida(c, c->secaoTropas, sizeof(int32_t) * n) ||
+        !secaoValida(c, c->secaoInicioNome, sizeof(int32_t) * (n + 1)) ||
+        !secaoValida(c, c->secaoNomes, c->bytesNomes + 1))
+        return 0;
+    if (c->secaoInicioGrafo != 0 &&
+        (!secaoValida(c, c->secaoInicioGrafo, sizeof(int32_t) * (n + 1)) ||
+         !secaoValida(c, c->secaoVizinhos, sizeof(int32_t) * (uint64_t) c->numVizinhos)))
+        return 0;
+    return 1;
+}
+
+/* Uma passada O(n + m) pelos vetores que indexam outros: donos (de
+   territórios e jogadores) entre as cores salvas, início dos nomes crescente
+   e dentro da tabela, CSR crescente e vizinhos dentro do mapa. Um arquivo
+   truncado ou corrompido é recusado aqui, antes de qualquer leitura fora. */
+static int conteudoValido(const CabecalhoJogoSalvo* c, const char* b) {
+    int n = c->numTerritorios;
+    const int32_t* dono = (const int32_t*) (b + c->secaoDono);
+    const int32_t* inicioNome = (const int32_t*) (b + c->secaoInicioNome);
+    for (int i = 0; i < n; ++i) {
+        if (dono[i] < 0 || dono[i] >= c->numCores) return 0;
+        if (inicioNome[i] < 0 || inicioNome[i] > inicioNome[i + 1]) return 0;
+    }
+    if ((uint64_t) inicioNome[n] > c->bytesNomes || b[c->secaoNomes + c->bytesNomes] != '\0') return 0;
+
+    const JogadorSalvo* jogadores = (const JogadorSalvo*) (b + c->secaoJogadores);
+    for (int j = 0; j < c->numJogadores; ++j) {
+        if (jogadores[j].dono < 0 || jogadores[j].dono >= c->numCores) return 0;
+    }
+
+    if (c->secaoInicioGrafo == 0) return 1;
+    const int32_t* inicioGrafo = (const int32_t*) (b + c->secaoInicioGrafo);
+    const int32_t* vizinhos = (const int32_t*) (b + c->secaoVizinhos);
+    if (inicioGrafo[0] != 0 || inicioGrafo[n] != c->numVizinhos) return 0;
+    for (int i = 0; i < n; ++i) {
+        if (inicioGrafo[i] > inicioGrafo[i + 1]) return 0;
+    }
+    for (int k = 0; k < c->numVizinhos; ++k) {
+        if (vizinhos[k] < 0 || vizinhos[k] >= n) return 0;
+    }
+    return 1;
+}
+
+/* Mapeia o arquivo e monta mapa, grafo e jogadores apontando para ele.
+   Além do cabeçalho e dos limites das seções, os vetores de índices passam
+   por conteudoValido; o resto (tropas, nomes) é usado como está, e os donos
+   só são reescritos quando as cores salvas ganham outros ids no registro
+   atual. Retorna 0 se o arquivo não existir, não for um jogo salvo válido
+   ou o registro de cores encher. */
+int abrirJogoSalvo(JogoSalvo* jogo, const char* caminho) {
+    memset(jogo, 0, sizeof(*jogo));
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(CabecalhoJogoSalvo)) {
+        close(fd);
+        return 0;
+    }
+    size_t bytes = (size_t) info.st_size;
+    void* base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+
+    char* b = (char*) base;
+    const CabecalhoJogoSalvo* c = (const CabecalhoJogoSalvo*) base;
+    int n = c->numTerritorios;
+    int32_t* inicioNome = (int32_t*) (b + c->secaoInicioNome);
+    int32_t* inicioGrafo = (int32_t*) (b + c->secaoInicioGrafo);
+    if (!cabecalhoValido(c, bytes) || !conteudoValido(c, b)) {
+        munmap(base, bytes);
+        return 0;
+    }
+
+    // cores: registra na ordem salva e traduz os donos se os ids mudaram
+    int traducao[MAX_CORES];
+    int mudou = 0;
+    const char (*cores)[MAX_COR] = (const char (*)[MAX_COR]) (b + c->secaoCores);
+    for (int k = 0; k < c->numCores; ++k) {
+        char nome[MAX_COR];
+        memcpy(nome, cores[k], MAX_COR);
+        nome[MAX_COR - 1] = '\0';
+        traducao[k] = registrarCor(nome);
+        if (traducao[k] < 0) {
+            munmap(base, bytes);
+            return 0;
+        }
+        mudou |= traducao[k] != k;
+    }
+    int32_t* dono = (int32_t*) (b + c->secaoDono);
+    if (mudou) {
+        for (int i = 0; i < n; ++i) dono[i] = traducao[dono[i]];
+    }
+
+    jogo->base = base;
+    jogo->bytes = bytes;
+    jogo->mapa.tamanho = n;
+    jogo->mapa.dono = dono;
+    jogo->mapa.tropas = (int32_t*) (b + c->secaoTropas);
+    jogo->mapa.inicioNome = inicioNome;
+    jogo->mapa.nomes = b + c->secaoNomes;
+    jogo->mapa.capacidadeNomes = (size_t) c->bytesNomes;
+    jogo->mapa.nomesDefinidos = n;
+    jogo->mapa.bloco = NULL;
+    if (c->secaoInicioGrafo != 0) {
+        jogo->temGrafo = 1;
+        jogo->grafo.numTerritorios = n;
+        jogo->grafo.inicio = inicioGrafo;
+        jogo->grafo.vizinhos = (int32_t*) (b + c->secaoVizinhos);
+    }
+    jogo->numJogadores = c->numJogadores;
+    memcpy(jogo->jogadores, b + c->secaoJogadores, sizeof(JogadorSalvo) * c->numJogadores);
+    for (int j = 0; j < jogo->numJogadores; ++j) jogo->jogadores[j].dono = traducao[jogo->jogadores[j].dono];
+    jogo->turno = c->turno;
+    return 1;
+}
+
+void fecharJogoSalvo(JogoSalvo* jogo) {
+    if (jogo->base) munmap(jogo->base, jogo->bytes);
+    memset(jogo, 0, sizeof(*jogo));
+}
@@ -0,0 +1,72 @@
+/* war_arquivo.h
+   Jogo salvo em formato binário versionado: cabeçalho, cores, jogadores,
+   vetores de dono e tropas, tabela de nomes e (opcional) fronteiras em CSR.
+   Cada seção é uma cópia direta da memória, alinhada em 64 bytes, então
+   abrirJogoSalvo() só mapeia o arquivo (mmap) e aponta o Mapa e o GrafoMapa
+   para dentro dele, sem ler território por território.
+
+   O arquivo usa a ordem de bytes da máquina que o gravou; um arquivo de outra
+   ordem é recusado pela versão, que não bate.
+*/
+
+#ifndef WAR_ARQUIVO_H
+#define WAR_ARQUIVO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "war_jogo.h"
+
+#define MAGICA_JOGO_SALVO "WARSAVE"
+#define VERSAO_JOGO_SALVO 1
+#define MAX_JOGADORES_SALVOS 8
+
+typedef struct {
+    int32_t dono;       // id da cor no registro
+    int32_t idMissao;   // id da missão em missoesDisponiveis (0 = nenhuma)
+} JogadorSalvo;
+
+/* Cabeçalho gravado no início do arquivo. As posições das seções são
+   deslocamentos em bytes a partir do início; 0 = seção ausente. */
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t bytesCabecalho;
+    int32_t numTerritorios;
+    int32_t numCores;
+    int32_t numJogadores;
+    int32_t turno;
+    int32_t numVizinhos;        // entradas do vetor de vizinhos (0 sem fronteiras)
+    uint32_t reservado;
+    uint64_t bytesNomes;        // tabela de nomes, sem contar o '\0' final extra
+    uint64_t bytesArquivo;
+    uint64_t secaoCores;        // numCores * MAX_COR bytes
+    uint64_t secaoJogadores;    // numJogadores * JogadorSalvo
+    uint64_t secaoDono;         // numTerritorios * int32
+    uint64_t secaoTropas;       // numTerritorios * int32
+    uint64_t secaoInicioNome;   // (numTerritorios + 1) * int32
+    uint64_t secaoNomes;        // bytesNomes + 1
+    uint64_t secaoInicioGrafo;  // (numTerritorios + 1) * int32
+    uint64_t secaoVizinhos;     // numVizinhos * int32
+} CabecalhoJogoSalvo;
+
+/* Jogo aberto de um arquivo. Mapa e grafo apontam para o arquivo mapeado
+   (cópia privada: alterar o mapa não altera o arquivo) e valem até
+   fecharJogoSalvo(); não chame liberarMapa/liberarGrafo neles. */
+typedef struct {
+    void* base;
+    size_t bytes;
+    Mapa mapa;
+    GrafoMapa grafo;
+    int temGrafo;
+    int numJogadores;
+    JogadorSalvo jogadores[MAX_JOGADORES_SALVOS]; // donos já traduzidos para o registro atual
+    int turno;
+} JogoSalvo;
+
+int salvarJogo(const char* caminho, const Mapa* mapa, const GrafoMapa* grafo,
+               const JogadorSalvo* jogadores, int numJogadores, int turno);
+int abrirJogoSalvo(JogoSalvo* jogo, const char* caminho);
+void fecharJogoSalvo(JogoSalvo* jogo);
+
+#endif
@@ -0,0 +1,519 @@
+/* war_bench.c
+   Medição das primitivas do jogo e da vazão de partidas completas, com saída
+   em JSON para comparar um commit com outro (make bench).
+
+   Cada medição repete a operação em lotes que dobram de tamanho até um lote
+   levar pelo menos o tempo mínimo (-t), e registra o tempo por operação
+   desse lote. Mede:
+     - atacar() e atacarComGerador() entre dois territórios;
+     - atacarNoEstado() entre vizinhos, com os agregados por cor;
+     - verificarMissao() (texto, varre o mapa) e verificarMissaoNoEstado()
+       (compilada) para cada id de missão do catálogo;
+     - contarTerritoriosDoJogador, somarTropasDoJogador e reduzirPorDono;
+     - exibirMapa e exibirMapaColunar, com a saída desviada para /dev/null, e
+       um quadro da tela incremental (war_tela.h) com uma linha alterada;
+     - partidas completas com ataques legais sorteados, de 6 a 10^6
+       territórios e de 2 a 16 jogadores;
+     - um lote de turno simultâneo (war_ordens.h) em 10^5 territórios, com
+       16 jogadores e 512 ordens cada: em sequência e em paralelo com 1, 2,
+       4... threads até os núcleos disponíveis. Antes de medir, confere que
+       o paralelo deixa o mapa e os agregados iguais aos da sequência.
+
+   Uso: war_bench [-t segundos] [-m maxTerritorios] [-o saida.json]
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "war_jogo.h"
+#include "war_ordens.h"
+#include "war_reducao.h"
+#include "war_tela.h"
+
+#ifndef WAR_VERSAO
+#define WAR_VERSAO "desconhecida" // o Makefile passa o commit atual
+#endif
+
+#define MAX_JOGADORES_BENCH 16
+#define MAX_TURNOS_BENCH 200    // por partida: em 10^6 territórios cada turno varre o mapa
+#define SEMENTE_BENCH 12345
+#define TERRITORIOS_ORDENS_BENCH 100000
+#define JOGADORES_ORDENS_BENCH 16
+#define ORDENS_POR_JOGADOR_BENCH 512
+
+static const int tamanhosMapa[] = {6, 100, 10000, 1000000};
+static const int jogadoresPartida[] = {2, 4, 8, 16};
+
+typedef struct {
+    FILE* saida;
+    double tempoMinimo;
+    int resultados;
+} RelatorioBench;
+
+/* Uma operação medida: roda 'repeticoes' vezes sobre o contexto. */
+typedef void (*FuncaoBench)(void* contexto, long repeticoes);
+
+static volatile long long sumidouro; // impede que o compilador descarte os resultados
+
+static double agora(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void medir(RelatorioBench* r, const char* nome, const char* variante, int territorios, int jogadores,
+                  FuncaoBench funcao, void* contexto) {
+    long repeticoes = 1;
+    double segundos;
+    for (;;) {
+        double inicio = agora();
+        funcao(contexto, repeticoes);
+        segundos = agora() - inicio;
+        if (segundos >= r->tempoMinimo || repeticoes >= (1L << 40)) break;
+        repeticoes *= 2;
+    }
+    fprintf(r->saida,
+            "%s\n    {\"nome\": \"%s\", \"variante\": \"%s\", \"territorios\": %d, \"jogadores\": %d, "
+            "\"repeticoes\": %ld, \"segundos\": %.6f, \"ns_por_operacao\": %.3f, \"operacoes_por_segundo\": %.1f}",
+            r->resultados ? "," : "", nome, variante, territorios, jogadores, repeticoes, segundos,
+            1e9 * segundos / repeticoes, repeticoes / segundos);
+    r->resultados++;
+    fprintf(stderr, "%-26s %-12s %8d territórios %3d jogadores: %12.1f ns\n", nome, variante, territorios,
+            jogadores, 1e9 * segundos / repeticoes);
+}
+
+/* ----------------------- Cenário ----------------------- */
+
+/* Mapa de 'tamanho' territórios com as cores em rodízio entre os jogadores e
+   a cor neutra "Vermelho" (alvo da missão 2); o território 0 é "Fortaleza". */
+typedef struct {
+    int tamanho;
+    int numJogadores;
+    int donos[MAX_JOGADORES_BENCH];
+    Territorio* territorios;   // mesmo mapa no formato antigo, para as funções por Territorio
+    Mapa inicial;
+    Mapa mapa;
+    GrafoMapa grafo;
+    EstadoJogo estado;
+    GeradorAleatorio gerador;
+    Missao* catalogo;
+    Missao missoes[MAX_JOGADORES_BENCH];
+    Ataque* ataques;
+    int capacidadeAtaques;
+} CenarioBench;
+
+static int criarCenario(CenarioBench* c, int tamanho, int numJogadores) {
+    memset(c, 0, sizeof(*c));
+    c->tamanho = tamanho;
+    c->numJogadores = numJogadores;
+    geradorIniciar(&c->gerador, SEMENTE_BENCH);
+    char nome[MAX_NOME];
+    for (int j = 0; j < numJogadores; ++j) {
+        snprintf(nome, sizeof(nome), "J%d", j + 1);
+        c->donos[j] = registrarCor(nome);
+    }
+    int vermelho = registrarCor("Vermelho");
+    c->territorios = (Territorio*) malloc(sizeof(Territorio) * tamanho);
+    c->catalogo = (Missao*) malloc(sizeof(Missao) * totalMissoesDisponiveis);
+    if (!c->territorios || !c->catalogo) return 0;
+    for (int i = 0; i < tamanho; ++i) {
+        Territorio* t = &c->territorios[i];
+        if (i == 0) strcpy(t->nome, "Fortaleza");
+        else snprintf(t->nome, sizeof(t->nome), "T%d", i);
+        t->dono = (i % (numJogadores + 1)) < numJogadores ? c->donos[i % (numJogadores + 1)] : vermelho;
+        t->tropas = 1 + geradorIntervalo(&c->gerador, 5);
+    }
+    if (!criarMapaDeTerritorios(&c->inicial, c->territorios, tamanho, NULL)) return 0;
+    if (!copiarMapaCompartilhandoNomes(&c->mapa, &c->inicial)) return 0;
+    if (!criarGrafoGrade(&c->grafo, tamanho)) return 0;
+    iniciarEstadoJogo(&c->estado, &c->mapa, &c->grafo, &c->gerador);
+    for (int i = 0; i < totalMissoesDisponiveis; ++i) compilarMissao(&c->catalogo[i], missoesDisponiveis[i], &c->estado);
+    c->capacidadeAtaques = c->grafo.inicio[tamanho] > 0 ? c->grafo.inicio[tamanho] : 1;
+    c->ataques = (Ataque*) malloc(sizeof(Ataque) * c->capacidadeAtaques);
+    return c->ataques != NULL;
+}
+
+static void liberarCenario(CenarioBench* c) {
+    free(c->territorios);
+    free(c->catalogo);
+    free(c->ataques);
+    liberarMapa(&c->mapa);
+    liberarMapa(&c->inicial);
+    liberarGrafo(&c->grafo);
+}
+
+/* ----------------------- Primitivas ----------------------- */
+
+static void benchAtacar(void* contexto, long repeticoes) {
+    (void) contexto;
+    Territorio atacante = {"Colina", 0, 0}, defensor = {"Vale", 1, 0};
+    long long soma = 0;
+    for (long i = 0; i < repeticoes; ++i) {
+        atacante.dono = 0; atacante.tropas = 5;
+        defensor.dono = 1; defensor.tropas = 3;
+        atacar(&atacante, &defensor);
+        soma += defensor.dono;
+    }
+    sumidouro += soma;
+}
+
+static void benchAtacarComGerador(void* contexto, long repeticoes) {
+    GeradorAleatorio* g = (GeradorAleatorio*) contexto;
+    Territorio atacante = {"Colina", 0, 0}, defensor = {"Vale", 1, 0};
+    long long soma = 0;
+    for (long i = 0; i < repeticoes; ++i) {
+        atacante.dono = 0; atacante.tropas = 5;
+        defensor.dono = 1; defensor.tropas = 3;
+        atacarComGerador(&atacante, &defensor, g);
+        soma += defensor.dono;
+    }
+    sumidouro += soma;
+}
+
+/* Ataques entre vizinhos sorteados; o mapa volta ao inicial a cada 4096
+   ataques para não se esvaziar de tropas (a restauração entra na medida). */
+static void benchAtacarNoEstado(void* contexto, long repeticoes) {
+    CenarioBench* c = (CenarioBench*) contexto;
+    for (long i = 0; i < repeticoes; ++i) {
+        if ((i & 4095) == 0) {
+            restaurarMapa(&c->mapa, &c->inicial);
+            recalcularAgregados(&c->estado);
+        }
+        int a = geradorIntervalo(&c->gerador, c->tamanho);
+        int grau = c->grafo.inicio[a + 1] - c->grafo.inicio[a];
+        if (grau == 0) continue;
+        int d = c->grafo.vizinhos[c->grafo.inicio[a] + geradorIntervalo(&c->gerador, grau)];
+        atacarNoEstado(&c->estado, a, d);
+    }
+}
+
+typedef struct {
+    CenarioBench* cenario;
+    int indiceMissao;
+} ContextoMissao;
+
+static void benchVerificarMissao(void* contexto, long repeticoes) {
+    ContextoMissao* m = (ContextoMissao*) contexto;
+    CenarioBench* c = m->cenario;
+    long long soma = 0;
+    for (long i = 0; i < repeticoes; ++i)
+        soma += verificarMissao(missoesDisponiveis[m->indiceMissao], c->territorios, c->tamanho, c->donos[0]);
+    sumidouro += soma;
+}
+
+static void benchVerificarMissaoNoEstado(void* contexto, long repeticoes) {
+    ContextoMissao* m = (ContextoMissao*) contexto;
+    CenarioBench* c = m->cenario;
+    long long soma = 0;
+    for (long i = 0; i < repeticoes; ++i)
+        soma += verificarMissaoNoEstado(&c->catalogo[m->indiceMissao], &c->estado, c->donos[0]);
+    sumidouro += soma;
+}
+
+static void benchContarTerritorios(void* contexto, long repeticoes) {
+    CenarioBench* c = (CenarioBench*) contexto;
+    long long soma = 0;
+    for (long i = 0; i < repeticoes; ++i) soma += contarTerritoriosDoJogador(c->territorios, c->tamanho, c->donos[0]);
+    sumidouro += soma;
+}
+
+static void benchSomarTropas(void* contexto, long repeticoes) {
+    CenarioBench* c = (CenarioBench*) contexto;
+    long long soma = 0;
+    for (long i = 0; i < repeticoes; ++i) soma += somarTropasDoJogador(c->territorios, c->tamanho, c->donos[0]);
+    sumidouro += soma;
+}
+
+static void benchReduzirPorDono(void* contexto, long repeticoes) {
+    CenarioBench* c = (CenarioBench*) contexto;
+    int territorios[MAX_CORES];
+    long long tropas[MAX_CORES];
+    for (long i = 0; i < repeticoes; ++i) {
+        reduzirPorDono(&c->mapa, registroCores.total, territorios, tropas);
+        sumidouro += tropas[c->donos[0]];
+    }
+}
+
+/* A saída padrão vai para /dev/null enquanto o mapa é desenhado. */
+static int desviarSaida(void) {
+    fflush(stdout);
+    int original = dup(STDOUT_FILENO);
+    int nulo = open("/dev/null", O_WRONLY);
+    if (original < 0 || nulo < 0) {
+        if (original >= 0) close(original);
+        if (nulo >= 0) close(nulo);
+        return -1;
+    }
+    dup2(nulo, STDOUT_FILENO);
+    close(nulo);
+    return original;
+}
+
+static void restaurarSaida(int original) {
+    fflush(stdout);
+    dup2(original, STDOUT_FILENO);
+    close(original);
+}
+
+static void benchExibirMapa(void* contexto, long repeticoes) {
+    CenarioBench* c = (CenarioBench*) contexto;
+    for (long i = 0; i < repeticoes; ++i) exibirMapa(c->territorios, c->tamanho);
+    fflush(stdout);
+}
+
+static void benchExibirMapaColunar(void* contexto, long repeticoes) {
+    CenarioBench* c = (CenarioBench*) contexto;
+    for (long i = 0; i < repeticoes; ++i) exibirMapaColunar(&c->mapa);
+    fflush(stdout);
+}
+
+/* Um quadro por repetição, depois de mudar as tropas de um território da
+   página: o custo do turno típico do nível mestre, que não cresce com o mapa. */
+static void benchDesenharTela(void* contexto, long repeticoes) {
+    CenarioBench* c = (CenarioBench*) contexto;
+    TelaMapa tela;
+    if (!criarTelaMapa(&tela, &c->mapa, stdout, LINHAS_POR_PAGINA_PADRAO, 1)) return;
+    desenharTela(&tela);
+    int linhas = c->mapa.tamanho < tela.linhasPorPagina ? c->mapa.tamanho : tela.linhasPorPagina;
+    for (long i = 0; i < repeticoes; ++i) {
+        c->mapa.tropas[i % linhas]++;
+        sumidouro += desenharTela(&tela);
+    }
+    liberarTelaMapa(&tela);
+}
+
+/* ----------------------- Partidas completas ----------------------- */
+
+/* Mesmo laço do simulador: um ataque legal sorteado por turno (ou passe), e a
+   verificação de todas as missões no fim de cada turno. */
+static void benchPartida(void* contexto, long repeticoes) {
+    CenarioBench* c = (CenarioBench*) contexto;
+    long long turnosTotais = 0;
+    for (long p = 0; p < repeticoes; ++p) {
+        restaurarMapa(&c->mapa, &c->inicial);
+        recalcularAgregados(&c->estado);
+        for (int j = 0; j < c->numJogadores; ++j)
+            c->missoes[j] = c->catalogo[geradorIntervalo(&c->gerador, totalMissoesDisponiveis)];
+        int passesSeguidos = 0, vencedor = -1;
+        for (int turno = 0; turno < MAX_TURNOS_BENCH && vencedor < 0 && passesSeguidos < c->numJogadores;
+             ++turno) {
+            int dono = c->donos[turno % c->numJogadores];
+            int total = gerarAtaquesLegais(&c->estado, dono, c->ataques, c->capacidadeAtaques);
+            if (total > 0) {
+                const Ataque* a = &c->ataques[geradorIntervalo(&c->gerador, total)];
+                atacarNoEstado(&c->estado, a->atacante, a->defensor);
+                passesSeguidos = 0;
+            } else {
+                passesSeguidos++;
+            }
+            for (int j = 0; j < c->numJogadores && vencedor < 0; ++j) {
+                if (verificarMissaoNoEstado(&c->missoes[j], &c->estado, c->donos[j])) vencedor = j;
+            }
+            turnosTotais++;
+        }
+    }
+    sumidouro += turnosTotais;
+}
+
+/* ----------------------- Turno simultâneo ----------------------- */
+
+/* O mesmo lote de ordens, sorteado uma vez entre os ataques legais do mapa
+   inicial. Cada repetição volta só os territórios das ordens ao mapa
+   inicial, para não medir a cópia do mapa inteiro. */
+typedef struct {
+    CenarioBench* c;
+    ResolvedorOrdens resolvedor;
+    Ataque* lote;       // ORDENS_POR_JOGADOR_BENCH por jogador
+    int quantidade[MAX_JOGADORES_BENCH];
+    AgregadosJogo agregadosIniciais;
+    int paralela;
+} ContextoOrdens;
+
+static void entregarLoteBench(ContextoOrdens* o) {
+    CenarioBench* c = o->c;
+    for (int j = 0; j < c->numJogadores; ++j) {
+        const Ataque* ordens = &o->lote[j * ORDENS_POR_JOGADOR_BENCH];
+        for (int k = 0; k < o->quantidade[j]; ++k) {
+            int a = ordens[k].atacante, d = ordens[k].defensor;
+            c->mapa.dono[a] = c->inicial.dono[a];
+            c->mapa.tropas[a] = c->inicial.tropas[a];
+            c->mapa.dono[d] = c->inicial.dono[d];
+            c->mapa.tropas[d] = c->inicial.tropas[d];
+        }
+    }
+    c->estado.agregados = o->agregadosIniciais;
+    iniciarLoteOrdens(&o->resolvedor, c->numJogadores, 0, SEMENTE_BENCH);
+    for (int j = 0; j < c->numJogadores; ++j)
+        entregarOrdens(&o->resolvedor, j, c->donos[j], &o->lote[j * ORDENS_POR_JOGADOR_BENCH], o->quantidade[j]);
+}
+
+static void benchOrdens(void* contexto, long repeticoes) {
+    ContextoOrdens* o = (ContextoOrdens*) contexto;
+    long long executadas = 0;
+    for (long p = 0; p < repeticoes; ++p) {
+        entregarLoteBench(o);
+        executadas += o->paralela ? resolverOrdens(&o->resolvedor, &o->c->estado)
+                                  : resolverOrdensEmSequencia(&o->resolvedor, &o->c->estado);
+    }
+    sumidouro += executadas;
+}
+
+/* Resolve o lote em paralelo e em sequência a partir do mesmo mapa e
+   compara os dois resultados. */
+static int conferirOrdens(ContextoOrdens* o) {
+    CenarioBench* c = o->c;
+    size_t bytes = sizeof(int) * c->tamanho;
+    int* dono = (int*) malloc(bytes);
+    int* tropas = (int*) malloc(bytes);
+    if (!dono || !tropas) {
+        free(dono);
+        free(tropas);
+        return 0;
+    }
+    entregarLoteBench(o);
+    resolverOrdens(&o->resolvedor, &c->estado);
+    memcpy(dono, c->mapa.dono, bytes);
+    memcpy(tropas, c->mapa.tropas, bytes);
+    AgregadosJogo agregados = c->estado.agregados;
+    entregarLoteBench(o);
+    resolverOrdensEmSequencia(&o->resolvedor, &c->estado);
+    int iguais = memcmp(dono, c->mapa.dono, bytes) == 0 && memcmp(tropas, c->mapa.tropas, bytes) == 0 &&
+                 memcmp(&agregados, &c->estado.agregados, sizeof(agregados)) == 0;
+    free(dono);
+    free(tropas);
+    return iguais;
+}
+
+static void medirOrdens(RelatorioBench* r, int nucleos) {
+    CenarioBench c;
+    ContextoOrdens o;
+    memset(&o, 0, sizeof(o));
+    o.c = &c;
+    if (!criarCenario(&c, TERRITORIOS_ORDENS_BENCH, JOGADORES_ORDENS_BENCH) ||
+        !(o.lote = (Ataque*) malloc(sizeof(Ataque) * ORDENS_POR_JOGADOR_BENCH * c.numJogadores))) {
+        fprintf(stderr, "Sem memória para o mapa de %d territórios.\n", TERRITORIOS_ORDENS_BENCH);
+        liberarCenario(&c);
+        return;
+    }
+    o.agregadosIniciais = c.estado.agregados;
+    for (int j = 0; j < c.numJogadores; ++j) {
+        int total = gerarAtaquesLegais(&c.estado, c.donos[j], c.ataques, c.capacidadeAtaques);
+        o.quantidade[j] = total < ORDENS_POR_JOGADOR_BENCH ? total : ORDENS_POR_JOGADOR_BENCH;
+        for (int k = 0; k < o.quantidade[j]; ++k)
+            o.lote[j * ORDENS_POR_JOGADOR_BENCH + k] = c.ataques[geradorIntervalo(&c.gerador, total)];
+    }
+
+    char variante[32];
+    for (int threads = 0; threads <= nucleos; threads = threads ? threads * 2 : 1) {
+        // threads == 0: a referência sequencial
+        if (!criarResolvedorOrdens(&o.resolvedor, c.tamanho, ORDENS_POR_JOGADOR_BENCH * c.numJogadores,
+                                   threads ? threads : 1))
+            break;
+        o.paralela = threads > 0;
+        if (o.paralela && !conferirOrdens(&o)) {
+            fprintf(stderr, "ordens_simultaneas: o paralelo com %d threads não bate com a sequência.\n", threads);
+        } else {
+            if (o.paralela) snprintf(variante, sizeof(variante), "paralela_%d", o.resolvedor.numThreads);
+            else snprintf(variante, sizeof(variante), "sequencial");
+            medir(r, "ordens_simultaneas", variante, c.tamanho, c.numJogadores, benchOrdens, &o);
+        }
+        liberarResolvedorOrdens(&o.resolvedor);
+    }
+    free(o.lote);
+    liberarCenario(&c);
+}
+
+/* ----------------------- Função main ----------------------- */
+
+static void medirPrimitivas(RelatorioBench* r, int tamanho) {
+    CenarioBench c;
+    if (!criarCenario(&c, tamanho, 2)) {
+        fprintf(stderr, "Sem memória para o mapa de %d territórios.\n", tamanho);
+        liberarCenario(&c);
+        return;
+    }
+    char variante[16];
+    for (int i = 0; i < totalMissoesDisponiveis; ++i) {
+        ContextoMissao m = {&c, i};
+        snprintf(variante, sizeof(variante), "missao_%d", idDaMissao(missoesDisponiveis[i]));
+        medir(r, "verificar_missao", variante, tamanho, 2, benchVerificarMissao, &m);
+        medir(r, "verificar_missao_estado", variante, tamanho, 2, benchVerificarMissaoNoEstado, &m);
+    }
+    medir(r, "contar_territorios", "territorio", tamanho, 2, benchContarTerritorios, &c);
+    medir(r, "somar_tropas", "territorio", tamanho, 2, benchSomarTropas, &c);
+    medir(r, "reduzir_por_dono", nomeImplementacaoReducao(implementacaoReducaoAtiva()), tamanho, 2,
+          benchReduzirPorDono, &c);
+    medir(r, "atacar_estado", "gerador", tamanho, 2, benchAtacarNoEstado, &c);
+    int original = desviarSaida();
+    if (original >= 0) {
+        medir(r, "exibir_mapa", "territorio", tamanho, 2, benchExibirMapa, &c);
+        medir(r, "exibir_mapa", "colunar", tamanho, 2, benchExibirMapaColunar, &c);
+        medir(r, "exibir_mapa", "tela_incremental", tamanho, 2, benchDesenharTela, &c);
+        restaurarSaida(original);
+    }
+    liberarCenario(&c);
+}
+
+static void medirPartidas(RelatorioBench* r, int tamanho, int numJogadores) {
+    CenarioBench c;
+    if (!criarCenario(&c, tamanho, numJogadores)) {
+        fprintf(stderr, "Sem memória para o mapa de %d territórios.\n", tamanho);
+        liberarCenario(&c);
+        return;
+    }
+    medir(r, "partida", "aleatoria", tamanho, numJogadores, benchPartida, &c);
+    liberarCenario(&c);
+}
+
+static void exibirUso(const char* prog) {
+    fprintf(stderr, "Uso: %s [-t segundos] [-m maxTerritorios] [-o saida.json]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    RelatorioBench r = {stdout, 0.2, 0};
+    int maxTerritorios = 1000000;
+    const char* caminho = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) { exibirUso(argv[0]); return 1; }
+        const char* valor = argv[++i];
+        if (strcmp(argv[i - 1], "-t") == 0) r.tempoMinimo = atof(valor);
+        else if (strcmp(argv[i - 1], "-m") == 0) maxTerritorios = atoi(valor);
+        else if (strcmp(argv[i - 1], "-o") == 0) caminho = valor;
+        else { exibirUso(argv[0]); return 1; }
+    }
+    if (r.tempoMinimo <= 0.0 || maxTerritorios < 6) {
+        exibirUso(argv[0]);
+        return 1;
+    }
+    if (caminho && !(r.saida = fopen(caminho, "w"))) {
+        perror(caminho);
+        return 1;
+    }
+
+    fprintf(r.saida, "{\n  \"versao\": \"%s\",\n  \"tempo_minimo\": %.3f,\n  \"resultados\": [", WAR_VERSAO,
+            r.tempoMinimo);
+    GeradorAleatorio g;
+    geradorIniciar(&g, SEMENTE_BENCH);
+    medir(&r, "atacar", "rand", 2, 2, benchAtacar, NULL);
+    medir(&r, "atacar", "gerador", 2, 2, benchAtacarComGerador, &g);
+    int numTamanhos = sizeof(tamanhosMapa) / sizeof(tamanhosMapa[0]);
+    int numOpcoesJogadores = sizeof(jogadoresPartida) / sizeof(jogadoresPartida[0]);
+    for (int t = 0; t < numTamanhos && tamanhosMapa[t] <= maxTerritorios; ++t) medirPrimitivas(&r, tamanhosMapa[t]);
+    for (int t = 0; t < numTamanhos && tamanhosMapa[t] <= maxTerritorios; ++t) {
+        for (int j = 0; j < numOpcoesJogadores; ++j) medirPartidas(&r, tamanhosMapa[t], jogadoresPartida[j]);
+    }
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    if (maxTerritorios >= TERRITORIOS_ORDENS_BENCH) medirOrdens(&r, nucleos > 0 ? (int) nucleos : 1);
+    fprintf(r.saida, "\n  ]\n}\n");
+    if (caminho && fclose(r.saida) != 0) {
+        perror(caminho);
+        return 1;
+    }
+    return 0;
+}
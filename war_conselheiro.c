@@ -0,0 +1,177 @@
+/* war_conselheiro.c
+   Chances exatas (com a cauda geométrica cortada) e memoizadas de um ataque
+   ou cadeia de ataques, e a estimativa por Monte Carlo usada para conferi-las.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "war_conselheiro.h"
+#include "war_dados.h"
+#include "war_metricas.h"
+
+#define CAPACIDADE_INICIAL_CHANCES 1024
+#define PESO_MINIMO 1e-15 // termos da série geométrica abaixo disso são descartados
+
+static const double PROB_VITORIA = 15.0 / 36.0;
+static const double PROB_FALHA = 21.0 / 36.0;
+
+/* Tropas que seguem para o território conquistado, como em atacar(). */
+static int tropasTransferidas(int tropas) {
+    int transfer = tropas / 2;
+    return transfer == 0 ? 1 : transfer;
+}
+
+/* Derrotas ou empates que o atacante aguenta contra um alvo antes de parar. */
+static int falhasPermitidas(int tentativasPorAlvo, int tropas) {
+    return tentativasPorAlvo > 0 && tentativasPorAlvo < tropas ? tentativasPorAlvo : tropas;
+}
+
+static unsigned long long hashChave(int tropasAtacante, int tropasDefensor, int profundidade) {
+    unsigned long long h = ((unsigned long long) (unsigned) tropasAtacante << 32) ^ (unsigned) tropasDefensor;
+    h ^= (unsigned long long) profundidade * 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+/* Sondagem linear: devolve a posição da chave ou a posição vazia onde ela entraria. */
+static EntradaChances* localizarEntrada(EntradaChances* entradas, int capacidade,
+                                        int tropasAtacante, int tropasDefensor, int profundidade) {
+    unsigned long long mascara = (unsigned long long) capacidade - 1;
+    unsigned long long i = hashChave(tropasAtacante, tropasDefensor, profundidade) & mascara;
+    for (;;) {
+        EntradaChances* e = &entradas[i];
+        if (e->profundidade == 0 ||
+            (e->tropasAtacante == tropasAtacante && e->tropasDefensor == tropasDefensor &&
+             e->profundidade == profundidade))
+            return e;
+        i = (i + 1) & mascara;
+    }
+}
+
+/* Dobra a tabela quando passa de 70% de ocupação. Sem memória, a tabela fica
+   como está e a consulta só deixa de ser guardada. */
+static int crescerTabela(ConselheiroAtaque* conselheiro) {
+    int novaCapacidade = conselheiro->capacidade * 2;
+    METRICA_CONTAR(CONTADOR_ALOCACOES);
+    EntradaChances* novas = (EntradaChances*) calloc(novaCapacidade, sizeof(EntradaChances));
+    if (!novas) return 0;
+    for (int i = 0; i < conselheiro->capacidade; ++i) {
+        EntradaChances* e = &conselheiro->entradas[i];
+        if (e->profundidade == 0) continue;
+        *localizarEntrada(novas, novaCapacidade, e->tropasAtacante, e->tropasDefensor, e->profundidade) = *e;
+    }
+    free(conselheiro->entradas);
+    conselheiro->entradas = novas;
+    conselheiro->capacidade = novaCapacidade;
+    return 1;
+}
+
+int criarConselheiro(ConselheiroAtaque* conselheiro, int tentativasPorAlvo) {
+    memset(conselheiro, 0, sizeof(*conselheiro));
+    METRICA_CONTAR(CONTADOR_ALOCACOES);
+    conselheiro->entradas = (EntradaChances*) calloc(CAPACIDADE_INICIAL_CHANCES, sizeof(EntradaChances));
+    if (!conselheiro->entradas) return 0;
+    conselheiro->capacidade = CAPACIDADE_INICIAL_CHANCES;
+    conselheiro->tentativasPorAlvo = tentativasPorAlvo < 0 ? 0 : tentativasPorAlvo;
+    return 1;
+}
+
+void liberarConselheiro(ConselheiroAtaque* conselheiro) {
+    free(conselheiro->entradas);
+    memset(conselheiro, 0, sizeof(*conselheiro));
+}
+
+/* Cadeia a partir de 'tropas' contra os 'profundidade' alvos seguintes.
+   Com k falhas antes da primeira vitória (probabilidade 21/36^k * 15/36), o
+   atacante conquista com tropas - k e segue do território conquistado com a
+   metade transferida; se esgotar as falhas permitidas, a cadeia para ali.
+   As tropas do defensor entram na chave, mas pelas regras de atacar() não
+   mudam o resultado: o defensor nunca perde tropas em uma batalha. */
+static ChancesAtaque calcularCadeia(ConselheiroAtaque* conselheiro, int tropas,
+                                    const int* tropasDefensores, int profundidade) {
+    if (profundidade == 0) return (ChancesAtaque){1.0, (double) tropas};
+    if (tropas <= 0) return (ChancesAtaque){0.0, 0.0};
+
+    conselheiro->consultas++;
+    EntradaChances* e = localizarEntrada(conselheiro->entradas, conselheiro->capacidade,
+                                         tropas, tropasDefensores[0], profundidade);
+    if (e->profundidade != 0) {
+        conselheiro->acertos++;
+        return e->chances;
+    }
+
+    ChancesAtaque r = {0.0, 0.0};
+    int maxFalhas = falhasPermitidas(conselheiro->tentativasPorAlvo, tropas);
+    double pesoFalhas = 1.0; // (21/36)^k
+    int k = 0;
+    for (; k < maxFalhas && pesoFalhas >= PESO_MINIMO; ++k, pesoFalhas *= PROB_FALHA) {
+        int restantes = tropas - k;
+        int transfer = tropasTransferidas(restantes);
+        ChancesAtaque resto = calcularCadeia(conselheiro, transfer, tropasDefensores + 1, profundidade - 1);
+        double peso = pesoFalhas * PROB_VITORIA;
+        r.probConquista += peso * resto.probConquista;
+        r.tropasRestantes += peso * ((restantes - transfer) + resto.tropasRestantes);
+    }
+    if (k == maxFalhas) r.tropasRestantes += pesoFalhas * (tropas - maxFalhas);
+
+    // a recursão pode ter crescido a tabela: procura a posição de novo
+    if ((conselheiro->ocupadas + 1) * 10 > conselheiro->capacidade * 7 && !crescerTabela(conselheiro))
+        return r;
+    e = localizarEntrada(conselheiro->entradas, conselheiro->capacidade, tropas, tropasDefensores[0], profundidade);
+    e->tropasAtacante = tropas;
+    e->tropasDefensor = tropasDefensores[0];
+    e->profundidade = profundidade;
+    e->chances = r;
+    conselheiro->ocupadas++;
+    return r;
+}
+
+/* Chance de conquistar um único alvo e tropas esperadas do atacante depois. */
+ChancesAtaque avaliarAtaque(ConselheiroAtaque* conselheiro, int tropasAtacante, int tropasDefensor) {
+    return avaliarCadeia(conselheiro, tropasAtacante, &tropasDefensor, 1);
+}
+
+/* Cadeia de até MAX_CADEIA alvos: o primeiro é atacado da origem e cada um
+   dos seguintes a partir do território conquistado antes dele. */
+ChancesAtaque avaliarCadeia(ConselheiroAtaque* conselheiro, int tropasAtacante,
+                            const int* tropasDefensores, int profundidade) {
+    if (profundidade < 0) profundidade = 0;
+    if (profundidade > MAX_CADEIA) profundidade = MAX_CADEIA;
+    return calcularCadeia(conselheiro, tropasAtacante, tropasDefensores, profundidade);
+}
+
+/* Mesma cadeia por amostragem: cada alvo custa um único sorteio geométrico
+   (sortearFalhasAteVitoria), então o custo também não depende das tropas. */
+ChancesAtaque estimarCadeiaMonteCarlo(GeradorAleatorio* g, int tentativasPorAlvo, int tropasAtacante,
+                                      const int* tropasDefensores, int profundidade, int amostras) {
+    ChancesAtaque r = {0.0, 0.0};
+    if (amostras <= 0) return r;
+    (void) tropasDefensores; // o defensor não influencia a batalha pelas regras de atacar()
+    if (profundidade > MAX_CADEIA) profundidade = MAX_CADEIA;
+    long conquistas = 0;
+    double somaTropas = 0.0;
+    for (int s = 0; s < amostras; ++s) {
+        int tropas = tropasAtacante;
+        long long total = 0;
+        int i = 0;
+        for (; i < profundidade && tropas > 0; ++i) {
+            int maxFalhas = falhasPermitidas(tentativasPorAlvo, tropas);
+            int falhas = sortearFalhasAteVitoria(g, maxFalhas);
+            if (falhas >= maxFalhas) {
+                tropas -= maxFalhas;
+                break;
+            }
+            int transfer = tropasTransferidas(tropas - falhas);
+            total += tropas - falhas - transfer;
+            tropas = transfer;
+        }
+        total += tropas;
+        if (i == profundidade && tropas > 0) conquistas++;
+        somaTropas += (double) total;
+    }
+    r.probConquista = (double) conquistas / amostras;
+    r.tropasRestantes = somaTropas / amostras;
+    return r;
+}
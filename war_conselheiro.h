@@ -0,0 +1,52 @@
+/* war_conselheiro.h
+   Conselheiro de ataques: estima a chance de conquistar um alvo (ou uma cadeia
+   de alvos, cada um atacado a partir do anterior) e as tropas que sobram,
+   seguindo as regras de atacar(): vitória só com dado maior, metade das tropas
+   segue para o território conquistado e cada derrota ou empate custa 1 tropa.
+
+   Como cada batalha falha com probabilidade fixa 21/36, as falhas antes da
+   primeira vitória seguem uma distribuição geométrica; a soma sobre elas é
+   cortada quando o peso fica abaixo de 1e-15, então o custo não depende do
+   tamanho dos exércitos (1.000.000 de tropas responde tão rápido quanto 5).
+   Os resultados ficam numa tabela hash por (tropas do atacante, tropas do
+   defensor, profundidade), e consultas repetidas não recalculam nada.
+*/
+
+#ifndef WAR_CONSELHEIRO_H
+#define WAR_CONSELHEIRO_H
+
+#include "war_aleatorio.h"
+
+#define MAX_CADEIA 32 // alvos em uma mesma cadeia de ataques
+
+typedef struct {
+    double probConquista;   // chance de conquistar todos os alvos da cadeia
+    double tropasRestantes; // tropas esperadas do atacante na origem e nos territórios conquistados
+} ChancesAtaque;
+
+typedef struct {
+    int tropasAtacante;
+    int tropasDefensor;
+    int profundidade;       // alvos restantes na cadeia (0 = posição vazia)
+    ChancesAtaque chances;
+} EntradaChances;
+
+typedef struct {
+    int tentativasPorAlvo;  // batalhas contra cada alvo (0 = até conquistar ou zerar as tropas)
+    EntradaChances* entradas;
+    int capacidade;         // potência de 2
+    int ocupadas;
+    long consultas;
+    long acertos;
+} ConselheiroAtaque;
+
+int criarConselheiro(ConselheiroAtaque* conselheiro, int tentativasPorAlvo);
+void liberarConselheiro(ConselheiroAtaque* conselheiro);
+
+ChancesAtaque avaliarAtaque(ConselheiroAtaque* conselheiro, int tropasAtacante, int tropasDefensor);
+ChancesAtaque avaliarCadeia(ConselheiroAtaque* conselheiro, int tropasAtacante,
+                            const int* tropasDefensores, int profundidade);
+ChancesAtaque estimarCadeiaMonteCarlo(GeradorAleatorio* g, int tentativasPorAlvo, int tropasAtacante,
+                                      const int* tropasDefensores, int profundidade, int amostras);
+
+#endif
@@ -0,0 +1,133 @@
+/* war_csv.c
+   Leitor de cenários em texto com buffer grande e erros por linha.
+*/
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "war_csv.h"
+
+static void definirErro(ErroImportacao* erro, int linha, const char* mensagem) {
+    if (!erro) return;
+    erro->linha = linha;
+    strncpy(erro->mensagem, mensagem, sizeof(erro->mensagem) - 1);
+    erro->mensagem[sizeof(erro->mensagem) - 1] = '\0';
+}
+
+int abrirLeitorCsv(LeitorCsv* leitor, FILE* f) {
+    memset(leitor, 0, sizeof(*leitor));
+    leitor->buffer = (char*) malloc(TAMANHO_BLOCO_CSV);
+    if (!leitor->buffer) return 0;
+    leitor->f = f;
+    leitor->capacidade = TAMANHO_BLOCO_CSV;
+    return 1;
+}
+
+void fecharLeitorCsv(LeitorCsv* leitor) {
+    free(leitor->buffer);
+    memset(leitor, 0, sizeof(*leitor));
+}
+
+/* Devolve em *linha a próxima linha (sem '\n', terminada em '\0'). Quando a
+   linha não cabe no que resta do buffer, o resto é movido para o início e o
+   buffer é completado com fread; só cresce se uma linha sozinha passar do
+   tamanho dele. Retorna 0 no fim do arquivo e -1 se faltar memória. */
+static int proximaLinha(LeitorCsv* leitor, char** linha) {
+    for (;;) {
+        char* inicio = leitor->buffer + leitor->inicio;
+        char* quebra = (char*) memchr(inicio, '\n', leitor->fim - leitor->inicio);
+        if (quebra || (leitor->fimArquivo && leitor->inicio < leitor->fim)) {
+            if (!quebra) quebra = leitor->buffer + leitor->fim; // última linha sem '\n'
+            *quebra = '\0';
+            leitor->inicio = (size_t) (quebra - leitor->buffer) + 1;
+            if (leitor->inicio > leitor->fim) leitor->inicio = leitor->fim;
+            leitor->linha++;
+            *linha = inicio;
+            return 1;
+        }
+        if (leitor->fimArquivo) return 0;
+
+        size_t resto = leitor->fim - leitor->inicio;
+        memmove(leitor->buffer, inicio, resto);
+        leitor->inicio = 0;
+        leitor->fim = resto;
+        if (leitor->fim + 1 >= leitor->capacidade) {
+            char* maior = (char*) realloc(leitor->buffer, leitor->capacidade * 2);
+            if (!maior) return -1;
+            leitor->buffer = maior;
+            leitor->capacidade *= 2;
+        }
+        // guarda 1 byte para o '\0' da última linha sem '\n'
+        size_t lidos = fread(leitor->buffer + leitor->fim, 1, leitor->capacidade - 1 - leitor->fim, leitor->f);
+        leitor->fim += lidos;
+        if (lidos == 0) leitor->fimArquivo = 1; // fim do arquivo ou erro: nunca espera de novo
+    }
+}
+
+/* Remove espaços das pontas do campo [inicio, fim) e o termina em '\0'. */
+static char* aparar(char* inicio, char* fim, size_t* tamanho) {
+    while (inicio < fim && isspace((unsigned char) *inicio)) inicio++;
+    while (fim > inicio && isspace((unsigned char) fim[-1])) fim--;
+    *fim = '\0';
+    *tamanho = (size_t) (fim - inicio);
+    return inicio;
+}
+
+/* Lê o próximo território. Retorna 1 com 'saida' preenchida, 0 no fim do
+   arquivo e -1 em caso de erro (descrito em 'erro', com o número da linha). */
+int lerTerritorioCsv(LeitorCsv* leitor, TerritorioCsv* saida, ErroImportacao* erro) {
+    char* linha;
+    int r;
+    while ((r = proximaLinha(leitor, &linha)) == 1) {
+        size_t tamanho = strlen(linha);
+        if (tamanho > 0 && linha[tamanho - 1] == '\r') linha[--tamanho] = '\0';
+        char* p = linha;
+        while (isspace((unsigned char) *p)) p++;
+        if (*p == '\0' || *p == '#') continue;
+        leitor->linhasUteis++;
+
+        char separador = strchr(linha, '\t') ? '\t' : strchr(linha, ';') ? ';' : ',';
+        char* sep1 = strchr(linha, separador);
+        char* sep2 = sep1 ? strchr(sep1 + 1, separador) : NULL;
+        if (!sep2 || strchr(sep2 + 1, separador)) {
+            definirErro(erro, leitor->linha, "esperados 3 campos: nome, cor, tropas");
+            return -1;
+        }
+        char* fimLinha = linha + tamanho;
+        saida->nome = aparar(linha, sep1, &saida->tamanhoNome);
+        saida->cor = aparar(sep1 + 1, sep2, &saida->tamanhoCor);
+        size_t tamanhoTropas;
+        char* tropas = aparar(sep2 + 1, fimLinha, &tamanhoTropas);
+
+        char* fimNumero;
+        errno = 0;
+        long valor = strtol(tropas, &fimNumero, 10);
+        if (tamanhoTropas == 0 || *fimNumero != '\0') {
+            if (leitor->linhasUteis == 1) continue; // cabeçalho "nome,cor,tropas"
+            definirErro(erro, leitor->linha, "tropas não é um número inteiro");
+            return -1;
+        }
+        if (errno == ERANGE || valor < 1 || valor > MAX_TROPAS_CSV) {
+            definirErro(erro, leitor->linha, "tropas fora do intervalo [1 - 1000000]");
+            return -1;
+        }
+        if (saida->tamanhoNome == 0 || saida->tamanhoCor == 0) {
+            definirErro(erro, leitor->linha, "nome e cor não podem ser vazios");
+            return -1;
+        }
+        saida->tropas = (int) valor;
+        saida->linha = leitor->linha;
+        return 1;
+    }
+    if (r < 0) {
+        definirErro(erro, leitor->linha + 1, "linha grande demais (falta de memória)");
+        return -1;
+    }
+    if (ferror(leitor->f)) {
+        definirErro(erro, 0, "erro de leitura");
+        return -1;
+    }
+    return 0;
+}
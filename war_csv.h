@@ -0,0 +1,53 @@
+/* war_csv.h
+   Leitura de cenários em texto, uma linha por território:
+
+       nome,cor,tropas        (também aceita ';' ou TAB como separador)
+
+   Linhas em branco e linhas começando com '#' são ignoradas, e a primeira
+   linha pode ser um cabeçalho (tropas não numéricas). O arquivo passa por um
+   buffer grande (fread em blocos de 1 MiB), sem prompt nem fgets por campo,
+   e cada erro informa o número da linha. Não depende dos outros módulos, então
+   também serve ao nivel-eventureiro.
+*/
+
+#ifndef WAR_CSV_H
+#define WAR_CSV_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define TAMANHO_BLOCO_CSV (1 << 20)
+#define MAX_TROPAS_CSV 1000000 // mesmo limite do cadastro interativo
+
+typedef struct {
+    int linha;          // 0 = erro sem linha (ex.: leitura ou memória)
+    char mensagem[96];
+} ErroImportacao;
+
+/* Território lido de uma linha. nome e cor apontam para o buffer do leitor
+   (terminados em '\0') e valem até a próxima chamada de lerTerritorioCsv. */
+typedef struct {
+    const char* nome;
+    size_t tamanhoNome;
+    const char* cor;
+    size_t tamanhoCor;
+    int tropas;
+    int linha;
+} TerritorioCsv;
+
+typedef struct {
+    FILE* f;
+    char* buffer;
+    size_t capacidade;
+    size_t inicio;      // próxima linha ainda não lida
+    size_t fim;         // bytes válidos no buffer
+    int fimArquivo;
+    int linha;
+    int linhasUteis;    // linhas não vazias e fora de comentários (o cabeçalho só pode ser a primeira)
+} LeitorCsv;
+
+int abrirLeitorCsv(LeitorCsv* leitor, FILE* f);
+void fecharLeitorCsv(LeitorCsv* leitor);
+int lerTerritorioCsv(LeitorCsv* leitor, TerritorioCsv* saida, ErroImportacao* erro);
+
+#endif
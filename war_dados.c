@@ -0,0 +1,75 @@
+/* war_dados.c
+   Tabela de pares de dados e probabilidades da batalha 1x1.
+*/
+
+#include <math.h>
+
+#include "war_dados.h"
+
+/* tabelaDuplasD6[b] para b = 0..251: r = b % 36, atacante = r / 6 + 1,
+   defensor = r % 6 + 1. Cada par aparece exatamente 7 vezes. */
+const uint8_t tabelaDuplasD6[LIMITE_BYTE_DADO] = {
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+    0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+    0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+    0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+    0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+    0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+    0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+    0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66
+};
+
+/* Contagens por enumeração dos lances: os dados de cada lado são ordenados
+   do maior para o menor e comparados em pares; empate favorece o defensor.
+   Ex.: 3x2 tem 2275 lances em que o defensor não perde nada, 2611 em que
+   cada lado perde 1 e 2890 em que o defensor perde 2. Para uma só
+   comparação o segundo limite é o total (nunca alcançado). */
+const RodadaClassica tabelaRodadasClassicas[3][2] = {
+    {{36, {21, 36}, 1}, {216, {161, 216}, 1}},
+    {{216, {91, 216}, 1}, {1296, {581, 1001}, 2}},
+    {{1296, {441, 1296}, 1}, {7776, {2275, 4886}, 2}}
+};
+
+/* Enumera os 36 pares possíveis da regra atual (um dado de cada lado). */
+ProbabilidadesBatalha probabilidadesBatalha1x1(void) {
+    ProbabilidadesBatalha p = {0, 0, 0, 0};
+    for (int a = 1; a <= 6; ++a) {
+        for (int d = 1; d <= 6; ++d) {
+            if (a > d) p.vitorias++;
+            else if (a == d) p.empates++;
+            else p.derrotas++;
+            p.total++;
+        }
+    }
+    return p;
+}
+
+/* Probabilidade exata de o atacante vencer uma batalha: 15/36. */
+double probabilidadeVitoriaAtacante(void) {
+    ProbabilidadesBatalha p = probabilidadesBatalha1x1();
+    return (double) p.vitorias / p.total;
+}
+
+/* Sorteia quantas batalhas seguidas o atacante perde antes da primeira vitória
+   (distribuição geométrica com p = 15/36), por inversão: um único sorteio no
+   lugar de rolar batalha por batalha. O resultado é limitado a maxFalhas. */
+int sortearFalhasAteVitoria(GeradorAleatorio* g, int maxFalhas) {
+    double logFalha = log(1.0 - probabilidadeVitoriaAtacante());
+    // u uniforme em (0, 1]: 53 bits + 1 evita log(0)
+    double u = ((geradorProximo(g) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    double falhas = floor(log(u) / logFalha);
+    return falhas >= maxFalhas ? maxFalhas : (int) falhas;
+}
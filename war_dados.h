@@ -0,0 +1,68 @@
+/* war_dados.h
+   Dados de seis faces sem viés, probabilidades exatas da batalha 1x1 e a
+   tabela de resultados das rodadas clássicas (war_regras.h).
+
+   Cada byte de uma saída do gerador vale um lance: bytes abaixo de 252
+   (= 7 * 36) são aceitos e os demais descartados, então b % 36 (um par
+   atacante/defensor) é exatamente uniforme. Uma batalha usa uma chamada do
+   gerador (os bytes seguintes só servem se o primeiro for descartado),
+   contra uma chamada de rand() por dado. Os dados não são rolados em lote:
+   o estado do gerador é tudo o que a partida guarda (war_historico.h) e o
+   que separa as ordens de um turno simultâneo (war_ordens.h), e uma reserva
+   de lances fora dele quebraria as duas coisas.
+*/
+
+#ifndef WAR_DADOS_H
+#define WAR_DADOS_H
+
+#include <stdint.h>
+
+#include "war_aleatorio.h"
+
+#define LIMITE_BYTE_DADO 252 // maior múltiplo de 36 que cabe em um byte
+
+/* Par de dados pré-calculado para cada byte aceito: (atacante << 4) | defensor. */
+extern const uint8_t tabelaDuplasD6[LIMITE_BYTE_DADO];
+
+/* Casos (entre os 36 pares possíveis) de cada resultado da regra atual:
+   o atacante só vence com dado estritamente maior. */
+typedef struct {
+    int vitorias;   // 15
+    int empates;    // 6
+    int derrotas;   // 15
+    int total;      // 36
+} ProbabilidadesBatalha;
+
+/* Rodada clássica com 'a' dados de ataque contra 'd' de defesa: dos 6^(a+d)
+   lances possíveis (total), os 'limites[0]' primeiros tiram 0 tropas do
+   defensor, os seguintes até 'limites[1]' tiram 1 e o resto tira 2. O
+   atacante perde as comparações que o defensor não perdeu. */
+typedef struct {
+    uint32_t total;
+    uint32_t limites[2];
+    int comparacoes; // min(a, d)
+} RodadaClassica;
+
+/* Indexada por [a - 1][d - 1], a em 1..3 e d em 1..2. */
+extern const RodadaClassica tabelaRodadasClassicas[3][2];
+
+ProbabilidadesBatalha probabilidadesBatalha1x1(void);
+double probabilidadeVitoriaAtacante(void);
+int sortearFalhasAteVitoria(GeradorAleatorio* g, int maxFalhas);
+
+/* Rola o par (atacante, defensor) com um único sorteio do gerador. */
+static inline void rolarDuplaD6(GeradorAleatorio* g, int* dadoAtacante, int* dadoDefensor) {
+    for (;;) {
+        uint64_t x = geradorProximo(g);
+        for (int k = 0; k < 8; ++k, x >>= 8) {
+            unsigned b = (unsigned) (x & 0xFF);
+            if (b < LIMITE_BYTE_DADO) {
+                *dadoAtacante = tabelaDuplasD6[b] >> 4;
+                *dadoDefensor = tabelaDuplasD6[b] & 0xF;
+                return;
+            }
+        }
+    }
+}
+
+#endif
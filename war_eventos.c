@@ -0,0 +1,138 @@
+/* war_eventos.c
+   Diário de eventos com buffer e os três formatos de saída.
+*/
+
+#include <string.h>
+
+#include "war_eventos.h"
+#include "war_jogo.h"
+#include "war_regras.h"
+
+#define MAX_TEXTO_EVENTO 256 // maior evento formatado (texto ou JSONL)
+
+_Thread_local DiarioEventos* diarioAtivo = NULL;
+
+static const char* nomeDoEvento(TipoEvento tipo) {
+    switch (tipo) {
+        case EVENTO_BATALHA: return "batalha";
+        case EVENTO_CONQUISTA: return "conquista";
+        case EVENTO_ELIMINACAO: return "eliminacao";
+        case EVENTO_MISSAO_CUMPRIDA: return "missao";
+        case EVENTO_ATAQUE_INVALIDO: return "invalido";
+        case EVENTO_INVESTIDA: return "investida";
+    }
+    return "?";
+}
+
+static NivelEventos nivelDoEvento(TipoEvento tipo) {
+    return tipo == EVENTO_BATALHA || tipo == EVENTO_ATAQUE_INVALIDO ? NIVEL_EVENTOS_BATALHA
+                                                                     : NIVEL_EVENTOS_PARTIDA;
+}
+
+static void acrescentar(DiarioEventos* diario, const void* dados, size_t bytes) {
+    if (diario->usados + bytes > sizeof(diario->buffer)) descarregarEventos(diario);
+    memcpy(diario->buffer + diario->usados, dados, bytes);
+    diario->usados += bytes;
+}
+
+/* Abre o diário sobre 'destino' (que continua sendo do chamador). O formato
+   binário começa com a mágica de 8 bytes. */
+void abrirDiarioEventos(DiarioEventos* diario, FILE* destino, FormatoEventos formato, NivelEventos nivel) {
+    diario->nivel = nivel;
+    diario->formato = formato;
+    diario->destino = destino;
+    diario->partida = 0;
+    diario->turno = 0;
+    diario->eventos = 0;
+    diario->usados = 0;
+    if (formato == FORMATO_EVENTOS_BINARIO) acrescentar(diario, MAGICA_EVENTOS, sizeof(MAGICA_EVENTOS));
+}
+
+void usarDiarioEventos(DiarioEventos* diario) {
+    diarioAtivo = diario;
+}
+
+/* Mesmas mensagens que as regras imprimiam antes do diário. */
+static int formatarTexto(char* s, size_t n, const Evento* e) {
+    switch (e->tipo) {
+        case EVENTO_BATALHA:
+            if (WAR_REGRAS != REGRAS_1X1)
+                return snprintf(s, n, "Batalha: %s (%d dado(s)) contra %s (%d dado(s)) | perdas: atacante %d, "
+                                      "defensor %d | ficam %d e %d tropas\n",
+                                e->nomeAtacante, e->dadoAtacante, e->nomeDefensor, e->dadoDefensor, e->valor >> 16,
+                                e->valor & 0xFFFF, e->tropasAtacante, e->tropasDefensor);
+            if (e->dadoAtacante > e->dadoDefensor)
+                return snprintf(s, n, "Rolagem atacante (%s) = %d | defensor (%s) = %d\n",
+                                e->nomeAtacante, e->dadoAtacante, e->nomeDefensor, e->dadoDefensor);
+            return snprintf(s, n, "Rolagem atacante (%s) = %d | defensor (%s) = %d\n"
+                                  "Defensor resiste! %s perde 1 tropa (agora tem %d).\n",
+                            e->nomeAtacante, e->dadoAtacante, e->nomeDefensor, e->dadoDefensor,
+                            e->nomeAtacante, e->tropasAtacante);
+        case EVENTO_CONQUISTA:
+            return snprintf(s, n, "Atacante vence! Transferindo %d tropas e mudando cor de %s para %s\n",
+                            e->valor, e->nomeDefensor, nomeDaCor(e->donoAtacante));
+        case EVENTO_ELIMINACAO:
+            return snprintf(s, n, "A cor %s não tem mais territórios.\n", nomeDaCor(e->donoDefensor));
+        case EVENTO_MISSAO_CUMPRIDA:
+            return snprintf(s, n, "A cor %s cumpriu a missão %d.\n", nomeDaCor(e->donoAtacante), e->valor);
+        case EVENTO_ATAQUE_INVALIDO:
+            if (e->valor == INVALIDO_MESMO_DONO) return snprintf(s, n, "Ataque inválido: mesmo dono.\n");
+            return snprintf(s, n, "%s não tem tropas suficientes para atacar.\n", e->nomeAtacante);
+        case EVENTO_INVESTIDA:
+            return snprintf(s, n, "%s perde %d tropa(s) e %s %s.\n", e->nomeAtacante, e->valor,
+                            e->donoDefensor == e->donoAtacante ? "conquista" : "desiste de", e->nomeDefensor);
+    }
+    return 0;
+}
+
+static int formatarJsonl(char* s, size_t n, const DiarioEventos* d, const Evento* e) {
+    return snprintf(s, n,
+                    "{\"tipo\":\"%s\",\"partida\":%ld,\"turno\":%d,\"atacante\":%d,\"defensor\":%d,"
+                    "\"donoAtacante\":%d,\"donoDefensor\":%d,\"dadoAtacante\":%d,\"dadoDefensor\":%d,"
+                    "\"tropasAtacante\":%d,\"tropasDefensor\":%d,\"valor\":%d}\n",
+                    nomeDoEvento(e->tipo), d->partida, d->turno, e->atacante, e->defensor,
+                    e->donoAtacante, e->donoDefensor, e->dadoAtacante, e->dadoDefensor,
+                    e->tropasAtacante, e->tropasDefensor, e->valor);
+}
+
+/* Formata o evento direto no buffer do diário ativo, se o nível permitir. */
+void emitirEvento(const Evento* evento) {
+    DiarioEventos* d = diarioAtivo;
+    if (!d || d->nivel < nivelDoEvento(evento->tipo)) return;
+    d->eventos++;
+    if (d->formato == FORMATO_EVENTOS_BINARIO) {
+        EventoBinario b = {(uint8_t) evento->tipo, (uint8_t) evento->dadoAtacante, (uint8_t) evento->dadoDefensor, 0,
+                           (int32_t) d->partida, d->turno, evento->atacante, evento->defensor,
+                           evento->donoAtacante, evento->donoDefensor,
+                           evento->tropasAtacante, evento->tropasDefensor, evento->valor};
+        acrescentar(d, &b, sizeof(b));
+        return;
+    }
+    if (d->usados + MAX_TEXTO_EVENTO > sizeof(d->buffer)) descarregarEventos(d);
+    char* s = d->buffer + d->usados;
+    int escritos = d->formato == FORMATO_EVENTOS_JSONL ? formatarJsonl(s, MAX_TEXTO_EVENTO, d, evento)
+                                                       : formatarTexto(s, MAX_TEXTO_EVENTO, evento);
+    if (escritos > 0) d->usados += escritos < MAX_TEXTO_EVENTO ? (size_t) escritos : MAX_TEXTO_EVENTO - 1;
+}
+
+/* Entrega o buffer ao destino com um único fwrite. */
+void descarregarEventos(DiarioEventos* diario) {
+    if (diario->usados == 0) return;
+    fwrite(diario->buffer, 1, diario->usados, diario->destino);
+    diario->usados = 0;
+    fflush(diario->destino);
+}
+
+/* Descarrega o que falta e desliga o diário se ele for o ativo da thread. */
+void fecharDiarioEventos(DiarioEventos* diario) {
+    descarregarEventos(diario);
+    if (diarioAtivo == diario) diarioAtivo = NULL;
+}
+
+/* Formato pela extensão do arquivo: .jsonl, .txt ou binário para o resto. */
+FormatoEventos formatoEventosPorNome(const char* caminho) {
+    const char* ponto = strrchr(caminho, '.');
+    if (ponto && strcmp(ponto, ".jsonl") == 0) return FORMATO_EVENTOS_JSONL;
+    if (ponto && strcmp(ponto, ".txt") == 0) return FORMATO_EVENTOS_TEXTO;
+    return FORMATO_EVENTOS_BINARIO;
+}
@@ -0,0 +1,107 @@
+/* war_eventos.h
+   Eventos do jogo (batalhas, conquistas, eliminações, missões cumpridas) no
+   lugar de printf espalhados pelas regras. As regras só montam um Evento
+   quando há um diário ativo na thread com nível suficiente; sem diário
+   (nível silencioso) o custo é um teste de ponteiro.
+
+   O diário formata cada evento em um buffer próprio e só chama fwrite quando
+   o buffer enche ou em descarregarEventos(), então um log completo de uma
+   simulação longa custa poucas chamadas de sistema. Formatos:
+     - texto: as mesmas mensagens do jogo interativo;
+     - JSONL: um objeto por linha;
+     - binário: cabeçalho "WAREVT1" seguido de registros EventoBinario.
+*/
+
+#ifndef WAR_EVENTOS_H
+#define WAR_EVENTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TAMANHO_BUFFER_EVENTOS (1 << 16)
+#define MAGICA_EVENTOS "WAREVT1"
+
+typedef enum {
+    NIVEL_EVENTOS_SILENCIOSO = 0,
+    NIVEL_EVENTOS_PARTIDA,   // conquistas, eliminações e missões cumpridas
+    NIVEL_EVENTOS_BATALHA    // também cada rolagem de dados e ataques inválidos
+} NivelEventos;
+
+typedef enum {
+    EVENTO_BATALHA = 1,
+    EVENTO_CONQUISTA,
+    EVENTO_ELIMINACAO,
+    EVENTO_MISSAO_CUMPRIDA,
+    EVENTO_ATAQUE_INVALIDO,
+    EVENTO_INVESTIDA
+} TipoEvento;
+
+typedef enum {
+    INVALIDO_MESMO_DONO = 1,
+    INVALIDO_SEM_TROPAS
+} MotivoAtaqueInvalido;
+
+typedef enum {
+    FORMATO_EVENTOS_TEXTO,
+    FORMATO_EVENTOS_JSONL,
+    FORMATO_EVENTOS_BINARIO
+} FormatoEventos;
+
+/* Índices são -1 quando não se aplicam (ex.: ataque entre dois Territorio
+   soltos). Os nomes só valem durante emitirEvento e só o texto os usa.
+   'valor' depende do tipo: tropas transferidas (conquista), falhas
+   (investida), motivo (ataque inválido), id da missão (missão cumprida) ou,
+   numa batalha das regras clássicas (war_regras.h), as perdas como
+   (atacante << 16) | defensor; aí os dados são quantos cada lado rolou. */
+typedef struct {
+    TipoEvento tipo;
+    int atacante, defensor;
+    const char* nomeAtacante;
+    const char* nomeDefensor;
+    int donoAtacante, donoDefensor;
+    int dadoAtacante, dadoDefensor;
+    int tropasAtacante, tropasDefensor; // depois do evento
+    int valor;
+} Evento;
+
+/* Registro de tamanho fixo do formato binário. */
+typedef struct {
+    uint8_t tipo;
+    uint8_t dadoAtacante;
+    uint8_t dadoDefensor;
+    uint8_t reservado;
+    int32_t partida;
+    int32_t turno;
+    int32_t atacante, defensor;
+    int32_t donoAtacante, donoDefensor;
+    int32_t tropasAtacante, tropasDefensor;
+    int32_t valor;
+} EventoBinario;
+
+typedef struct {
+    NivelEventos nivel;
+    FormatoEventos formato;
+    FILE* destino;
+    long partida;           // contexto copiado para cada evento
+    int turno;
+    long eventos;
+    size_t usados;
+    char buffer[TAMANHO_BUFFER_EVENTOS];
+} DiarioEventos;
+
+/* Diário da thread atual (NULL = silencioso). */
+extern _Thread_local DiarioEventos* diarioAtivo;
+
+void abrirDiarioEventos(DiarioEventos* diario, FILE* destino, FormatoEventos formato, NivelEventos nivel);
+void usarDiarioEventos(DiarioEventos* diario);
+void emitirEvento(const Evento* evento);
+void descarregarEventos(DiarioEventos* diario);
+void fecharDiarioEventos(DiarioEventos* diario);
+FormatoEventos formatoEventosPorNome(const char* caminho);
+
+static inline int eventosAtivos(NivelEventos nivel) {
+    return diarioAtivo && diarioAtivo->nivel >= nivel;
+}
+
+#endif
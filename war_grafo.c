@@ -0,0 +1,81 @@
+/* war_grafo.c
+   Construção do grafo de fronteiras em CSR.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "war_grafo.h"
+#include "war_metricas.h"
+
+/* Monta o CSR a partir de uma lista de fronteiras (cada uma vale nos dois
+   sentidos) em duas passadas: conta o grau de cada território e depois
+   preenche. Fronteiras com índices inválidos ou de um território com ele
+   mesmo são ignoradas. Retorna 0 se faltar memória. */
+int criarGrafo(GrafoMapa* grafo, int numTerritorios, const Fronteira* fronteiras, int numFronteiras) {
+    memset(grafo, 0, sizeof(*grafo));
+    METRICA_SOMAR(CONTADOR_ALOCACOES, 3); // inicio, vizinhos e o vetor temporário proximo
+    int* inicio = (int*) calloc(numTerritorios + 1, sizeof(int));
+    if (!inicio) return 0;
+
+    for (int e = 0; e < numFronteiras; ++e) {
+        int a = fronteiras[e].a, b = fronteiras[e].b;
+        if (a < 0 || b < 0 || a >= numTerritorios || b >= numTerritorios || a == b) continue;
+        inicio[a + 1]++;
+        inicio[b + 1]++;
+    }
+    for (int i = 0; i < numTerritorios; ++i) inicio[i + 1] += inicio[i];
+
+    int* vizinhos = (int*) malloc(sizeof(int) * (inicio[numTerritorios] > 0 ? inicio[numTerritorios] : 1));
+    int* proximo = (int*) malloc(sizeof(int) * (numTerritorios > 0 ? numTerritorios : 1));
+    if (!vizinhos || !proximo) {
+        free(inicio); free(vizinhos); free(proximo);
+        return 0;
+    }
+    memcpy(proximo, inicio, sizeof(int) * numTerritorios);
+    for (int e = 0; e < numFronteiras; ++e) {
+        int a = fronteiras[e].a, b = fronteiras[e].b;
+        if (a < 0 || b < 0 || a >= numTerritorios || b >= numTerritorios || a == b) continue;
+        vizinhos[proximo[a]++] = b;
+        vizinhos[proximo[b]++] = a;
+    }
+    free(proximo);
+
+    grafo->numTerritorios = numTerritorios;
+    grafo->inicio = inicio;
+    grafo->vizinhos = vizinhos;
+    return 1;
+}
+
+/* Grade retangular com largura ~ raiz de n: cada território faz fronteira com
+   o da direita e o de baixo. Usado pelos mapas gerados do simulador. */
+int criarGrafoGrade(GrafoMapa* grafo, int numTerritorios) {
+    int largura = 1;
+    while ((long) largura * largura < numTerritorios) largura++;
+
+    METRICA_CONTAR(CONTADOR_ALOCACOES);
+    Fronteira* fronteiras = (Fronteira*) malloc(sizeof(Fronteira) * 2 * (numTerritorios > 0 ? numTerritorios : 1));
+    if (!fronteiras) return 0;
+    int total = 0;
+    for (int i = 0; i < numTerritorios; ++i) {
+        if ((i + 1) % largura != 0 && i + 1 < numTerritorios) fronteiras[total++] = (Fronteira){i, i + 1};
+        if (i + largura < numTerritorios) fronteiras[total++] = (Fronteira){i, i + largura};
+    }
+    int ok = criarGrafo(grafo, numTerritorios, fronteiras, total);
+    free(fronteiras);
+    return ok;
+}
+
+void liberarGrafo(GrafoMapa* grafo) {
+    if (!grafo) return;
+    free(grafo->inicio);
+    free(grafo->vizinhos);
+    memset(grafo, 0, sizeof(*grafo));
+}
+
+int saoVizinhos(const GrafoMapa* grafo, int a, int b) {
+    for (int k = grafo->inicio[a]; k < grafo->inicio[a + 1]; ++k) {
+        if (grafo->vizinhos[k] == b) return 1;
+    }
+    return 0;
+}
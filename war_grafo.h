@@ -0,0 +1,31 @@
+/* war_grafo.h
+   Fronteiras entre territórios guardadas em formato CSR (compressed sparse row):
+   os vizinhos do território i ficam em vizinhos[inicio[i] .. inicio[i+1]-1].
+   Tudo fica em dois vetores contíguos, então percorrer as fronteiras de muitos
+   territórios seguidos não sai pulando pela memória.
+*/
+
+#ifndef WAR_GRAFO_H
+#define WAR_GRAFO_H
+
+typedef struct {
+    int numTerritorios;
+    int* inicio;    // numTerritorios + 1 posições
+    int* vizinhos;  // inicio[numTerritorios] posições (cada aresta aparece nos dois sentidos)
+} GrafoMapa;
+
+/* Aresta não direcionada entre dois índices de território. */
+typedef struct {
+    int a, b;
+} Fronteira;
+
+int criarGrafo(GrafoMapa* grafo, int numTerritorios, const Fronteira* fronteiras, int numFronteiras);
+int criarGrafoGrade(GrafoMapa* grafo, int numTerritorios);
+void liberarGrafo(GrafoMapa* grafo);
+int saoVizinhos(const GrafoMapa* grafo, int a, int b);
+
+static inline int grauTerritorio(const GrafoMapa* grafo, int i) {
+    return grafo->inicio[i + 1] - grafo->inicio[i];
+}
+
+#endif
@@ -0,0 +1,230 @@
+/* war_historico.c
+   Registro, desfazer/refazer e reprodução das ações de uma partida.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "war_historico.h"
+#include "war_metricas.h"
+
+#define CAPACIDADE_INICIAL_HISTORICO 256
+
+int criarHistorico(HistoricoJogo* h, uint64_t semente) {
+    h->semente = semente;
+    h->total = 0;
+    h->capacidade = CAPACIDADE_INICIAL_HISTORICO;
+    METRICA_CONTAR(CONTADOR_ALOCACOES);
+    h->acoes = (AcaoHistorico*) malloc(sizeof(AcaoHistorico) * h->capacidade);
+    return h->acoes != NULL;
+}
+
+void liberarHistorico(HistoricoJogo* h) {
+    free(h->acoes);
+    h->acoes = NULL;
+    h->total = h->capacidade = 0;
+}
+
+/* Reserva a próxima ação (dobrando o vetor quando enche), já zerada. */
+static AcaoHistorico* novaAcao(HistoricoJogo* h, TipoAcao tipo, int turno) {
+    if (h->total == h->capacidade) {
+        int capacidade = h->capacidade ? h->capacidade * 2 : CAPACIDADE_INICIAL_HISTORICO;
+        METRICA_CONTAR(CONTADOR_ALOCACOES);
+        AcaoHistorico* acoes = (AcaoHistorico*) realloc(h->acoes, sizeof(AcaoHistorico) * capacidade);
+        if (!acoes) return NULL;
+        h->acoes = acoes;
+        h->capacidade = capacidade;
+    }
+    AcaoHistorico* a = &h->acoes[h->total++];
+    memset(a, 0, sizeof(*a));
+    a->tipo = (uint8_t) tipo;
+    a->turno = turno;
+    return a;
+}
+
+static AcaoHistorico* novaAcaoDeAtaque(HistoricoJogo* h, TipoAcao tipo, int turno, const Mapa* mapa,
+                                        int idxAtq, int idxDef) {
+    AcaoHistorico* a = novaAcao(h, tipo, turno);
+    if (!a) return NULL;
+    a->atacante = idxAtq;
+    a->defensor = idxDef;
+    a->donoDefensorAntes = (uint8_t) mapa->dono[idxDef];
+    a->tropasAtacanteAntes = mapa->tropas[idxAtq];
+    a->tropasDefensorAntes = mapa->tropas[idxDef];
+    return a;
+}
+
+static void completarAcaoDeAtaque(AcaoHistorico* a, const Mapa* mapa) {
+    a->donoDefensorDepois = (uint8_t) mapa->dono[a->defensor];
+    a->tropasAtacanteDepois = mapa->tropas[a->atacante];
+    a->tropasDefensorDepois = mapa->tropas[a->defensor];
+}
+
+/* Ataca e registra o resultado; devolve 0 se faltou memória (o ataque
+   não é feito). */
+int atacarComHistorico(HistoricoJogo* h, EstadoJogo* estado, int turno, int idxAtq, int idxDef) {
+    AcaoHistorico* a = novaAcaoDeAtaque(h, ACAO_ATAQUE, turno, estado->mapa, idxAtq, idxDef);
+    if (!a) return 0;
+    a->dados = (uint8_t) atacarNoEstado(estado, idxAtq, idxDef);
+    completarAcaoDeAtaque(a, estado->mapa);
+    return 1;
+}
+
+/* Investida registrada como uma única ação; devolve o resultado de
+   investirNoEstado (1 se conquistou), ou -1 se faltou memória. */
+int investirComHistorico(HistoricoJogo* h, EstadoJogo* estado, int turno, int idxAtq, int idxDef) {
+    AcaoHistorico* a = novaAcaoDeAtaque(h, ACAO_INVESTIDA, turno, estado->mapa, idxAtq, idxDef);
+    if (!a) return -1;
+    int conquistou = investirNoEstado(estado, idxAtq, idxDef);
+    completarAcaoDeAtaque(a, estado->mapa);
+    return conquistou;
+}
+
+int registrarPasse(HistoricoJogo* h, int turno) {
+    return novaAcao(h, ACAO_PASSAR, turno) != NULL;
+}
+
+int registrarMissao(HistoricoJogo* h, int turno, int jogador, int idMissao) {
+    AcaoHistorico* a = novaAcao(h, ACAO_MISSAO, turno);
+    if (!a) return 0;
+    a->atacante = jogador;
+    a->defensor = idMissao;
+    return 1;
+}
+
+/* Desfaz a última ação e a retira do histórico. Devolve o turno em que ela
+   foi feita, ou -1 se não há o que desfazer (as missões não são desfeitas). */
+int desfazerAcao(HistoricoJogo* h, EstadoJogo* estado) {
+    if (h->total == 0 || h->acoes[h->total - 1].tipo == ACAO_MISSAO) return -1;
+    const AcaoHistorico* a = &h->acoes[--h->total];
+    if (a->tipo == ACAO_ATAQUE || a->tipo == ACAO_INVESTIDA) {
+        definirTerritoriosNoEstado(estado, a->atacante, a->tropasAtacanteAntes, a->defensor, a->donoDefensorAntes,
+                                   a->tropasDefensorAntes);
+    }
+    return a->turno;
+}
+
+/* Aplica o resultado gravado de uma ação, sem rolar dados. */
+void refazerAcao(EstadoJogo* estado, const AcaoHistorico* acao) {
+    if (acao->tipo != ACAO_ATAQUE && acao->tipo != ACAO_INVESTIDA) return;
+    definirTerritoriosNoEstado(estado, acao->atacante, acao->tropasAtacanteDepois, acao->defensor,
+                               acao->donoDefensorDepois, acao->tropasDefensorDepois);
+}
+
+static void inverterAcoes(AcaoHistorico* acoes, int inicio, int fim) {
+    for (int i = inicio, j = fim - 1; i < j; ++i, --j) {
+        AcaoHistorico t = acoes[i];
+        acoes[i] = acoes[j];
+        acoes[j] = t;
+    }
+}
+
+/* Refaz, sobre o mapa inicial da partida, as ações feitas antes de 'ateTurno'
+   (todas se ateTurno < 0). Devolve quantas ações foram usadas: as ações vêm
+   em ordem de turno, então são as primeiras do vetor. Devolve -1, sem mexer
+   no estado, se alguma ação do histórico cita um território fora do mapa ou
+   uma cor que não está no registro (histórico de outro mapa). */
+int reproduzirHistorico(const HistoricoJogo* h, EstadoJogo* estado, int ateTurno) {
+    unsigned tamanho = (unsigned) estado->mapa->tamanho, cores = (unsigned) registroCores.total;
+    for (int i = 0; i < h->total; ++i) {
+        const AcaoHistorico* a = &h->acoes[i];
+        if (a->tipo != ACAO_ATAQUE && a->tipo != ACAO_INVESTIDA) continue;
+        if ((unsigned) a->atacante >= tamanho || (unsigned) a->defensor >= tamanho ||
+            a->donoDefensorAntes >= cores || a->donoDefensorDepois >= cores)
+            return -1;
+    }
+    int i = 0;
+    for (; i < h->total; ++i) {
+        const AcaoHistorico* a = &h->acoes[i];
+        // missões não contam: depois de cortarHistorico elas ficam no início, fora da ordem de turno
+        if (ateTurno >= 0 && a->turno >= ateTurno && a->tipo != ACAO_MISSAO) break;
+        refazerAcao(estado, a);
+    }
+    return i;
+}
+
+/* Fica só com as 'total' primeiras ações, mais as missões que vinham depois
+   delas, levadas para o início do vetor (onde desfazerAcao não chega e
+   missaoNoHistorico ainda as encontra). Devolve o novo total. */
+int cortarHistorico(HistoricoJogo* h, int total) {
+    int fim = total;
+    for (int i = total; i < h->total; ++i) {
+        if (h->acoes[i].tipo == ACAO_MISSAO) h->acoes[fim++] = h->acoes[i];
+    }
+    // rotaciona [0, fim) para as missões [total, fim) virem antes das ações
+    inverterAcoes(h->acoes, 0, total);
+    inverterAcoes(h->acoes, total, fim);
+    inverterAcoes(h->acoes, 0, fim);
+    h->total = fim;
+    return fim;
+}
+
+/* Id da missão registrada para o jogador, ou -1. */
+int missaoNoHistorico(const HistoricoJogo* h, int jogador) {
+    for (int i = 0; i < h->total; ++i) {
+        if (h->acoes[i].tipo == ACAO_MISSAO && h->acoes[i].atacante == jogador) return h->acoes[i].defensor;
+    }
+    return -1;
+}
+
+int salvarHistorico(const char* caminho, const HistoricoJogo* h, const GeradorAleatorio* gerador) {
+    CabecalhoHistorico c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.magica, MAGICA_HISTORICO, sizeof(MAGICA_HISTORICO));
+    c.versao = VERSAO_HISTORICO;
+    c.bytesAcao = sizeof(AcaoHistorico);
+    c.semente = h->semente;
+    c.total = h->total;
+    c.gerador = *gerador;
+
+    FILE* f = fopen(caminho, "wb");
+    if (!f) return 0;
+    int ok = fwrite(&c, sizeof(c), 1, f) == 1;
+    if (ok && h->total > 0) ok = fwrite(h->acoes, sizeof(AcaoHistorico), (size_t) h->total, f) == (size_t) h->total;
+    if (fclose(f) != 0) ok = 0;
+    return ok;
+}
+
+/* Confere uma ação lida de um arquivo: tipo conhecido e, num ataque ou
+   investida, tropas não negativas e donos que cabem nos agregados. Índices
+   de território e cores do registro são conferidos por reproduzirHistorico,
+   que conhece o mapa. */
+static int acaoValida(const AcaoHistorico* a) {
+    if (a->tipo < ACAO_ATAQUE || a->tipo > ACAO_MISSAO) return 0;
+    if (a->tipo != ACAO_ATAQUE && a->tipo != ACAO_INVESTIDA) return 1;
+    return a->donoDefensorAntes < MAX_CORES && a->donoDefensorDepois < MAX_CORES && a->tropasAtacanteAntes >= 0 &&
+           a->tropasAtacanteDepois >= 0 && a->tropasDefensorAntes >= 0 && a->tropasDefensorDepois >= 0;
+}
+
+int carregarHistorico(HistoricoJogo* h, const char* caminho, GeradorAleatorio* gerador) {
+    h->acoes = NULL;
+    h->total = h->capacidade = 0;
+    FILE* f = fopen(caminho, "rb");
+    if (!f) return 0;
+    CabecalhoHistorico c;
+    int ok = fread(&c, sizeof(c), 1, f) == 1 && memcmp(c.magica, MAGICA_HISTORICO, sizeof(MAGICA_HISTORICO)) == 0 &&
+             c.versao == VERSAO_HISTORICO && c.bytesAcao == sizeof(AcaoHistorico) && c.total >= 0 &&
+             c.total <= 0x7FFFFFFF / 2;
+    if (ok) ok = criarHistorico(h, c.semente);
+    if (ok && c.total > h->capacidade) {
+        METRICA_CONTAR(CONTADOR_ALOCACOES);
+        AcaoHistorico* acoes = (AcaoHistorico*) realloc(h->acoes, sizeof(AcaoHistorico) * (size_t) c.total);
+        if (acoes) {
+            h->acoes = acoes;
+            h->capacidade = (int) c.total;
+        } else {
+            ok = 0;
+        }
+    }
+    if (ok) ok = fread(h->acoes, sizeof(AcaoHistorico), (size_t) c.total, f) == (size_t) c.total;
+    for (int64_t i = 0; ok && i < c.total; ++i) ok = acaoValida(&h->acoes[i]);
+    fclose(f);
+    if (!ok) {
+        liberarHistorico(h);
+        return 0;
+    }
+    h->total = (int) c.total;
+    *gerador = c.gerador;
+    return 1;
+}
@@ -0,0 +1,91 @@
+/* war_historico.h
+   Histórico de ações de uma partida: cada ataque, investida, passe e missão
+   atribuída vira um registro de 32 bytes, acrescentado a um vetor.
+
+   Um ataque guarda os dados rolados e os valores de antes e de depois dos
+   dois territórios envolvidos. Desfazer grava de volta os valores de antes e
+   refazer grava os de depois, com definirTerritoriosNoEstado: custa O(1) por
+   ação, sem copiar o mapa nem rolar dados de novo. Partindo do mesmo mapa
+   inicial, reproduzir o histórico reconstrói exatamente qualquer turno.
+
+   O arquivo leva a semente da partida e o estado do gerador no momento da
+   gravação. Reproduzir todas as ações não rola dados, então quem reproduz
+   o histórico inteiro devolve esse estado ao gerador para que os dados
+   seguintes sejam os que a partida original teria a partir dali (ex.: a
+   reprodução de um erro). Uma reprodução parcial não tem o estado do meio
+   da partida: os dados seguintes não repetem os da original.
+
+   Um arquivo com ação de tipo desconhecido, tropas negativas, território
+   fora do mapa ou cor fora do registro é recusado antes de tocar o estado
+   (carregarHistorico e reproduzirHistorico). Cortar o histórico numa
+   reprodução parcial mantém as missões atribuídas (cortarHistorico).
+*/
+
+#ifndef WAR_HISTORICO_H
+#define WAR_HISTORICO_H
+
+#include <stdint.h>
+
+#include "war_jogo.h"
+
+#define MAGICA_HISTORICO "WARHIST"
+#define VERSAO_HISTORICO 2
+
+typedef enum {
+    ACAO_ATAQUE = 1,
+    ACAO_INVESTIDA,
+    ACAO_PASSAR,
+    ACAO_MISSAO     // atacante = índice do jogador, defensor = id da missão
+} TipoAcao;
+
+typedef struct {
+    uint8_t tipo;
+    uint8_t dados;              // (atacante << 4) | defensor; 0 sem rolagem
+    uint8_t donoDefensorAntes;
+    uint8_t donoDefensorDepois;
+    int32_t turno;
+    int32_t atacante;
+    int32_t defensor;
+    int32_t tropasAtacanteAntes;
+    int32_t tropasAtacanteDepois;
+    int32_t tropasDefensorAntes;
+    int32_t tropasDefensorDepois;
+} AcaoHistorico;
+
+typedef struct {
+    uint64_t semente;
+    AcaoHistorico* acoes;
+    int total;
+    int capacidade;
+} HistoricoJogo;
+
+/* Cabeçalho do arquivo gravado por salvarHistorico; as ações vêm logo depois. */
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t bytesAcao;
+    uint64_t semente;
+    int64_t total;
+    GeradorAleatorio gerador;   // estado do gerador da partida ao gravar
+} CabecalhoHistorico;
+
+int criarHistorico(HistoricoJogo* h, uint64_t semente);
+void liberarHistorico(HistoricoJogo* h);
+
+/* Executam a ação no estado e a acrescentam ao histórico. */
+int atacarComHistorico(HistoricoJogo* h, EstadoJogo* estado, int turno, int idxAtq, int idxDef);
+int investirComHistorico(HistoricoJogo* h, EstadoJogo* estado, int turno, int idxAtq, int idxDef);
+int registrarPasse(HistoricoJogo* h, int turno);
+int registrarMissao(HistoricoJogo* h, int turno, int jogador, int idMissao);
+
+int desfazerAcao(HistoricoJogo* h, EstadoJogo* estado);
+void refazerAcao(EstadoJogo* estado, const AcaoHistorico* acao);
+int reproduzirHistorico(const HistoricoJogo* h, EstadoJogo* estado, int ateTurno);
+int cortarHistorico(HistoricoJogo* h, int total);
+int missaoNoHistorico(const HistoricoJogo* h, int jogador);
+
+/* 'gerador' é o gerador da partida: gravado com o histórico e devolvido na leitura. */
+int salvarHistorico(const char* caminho, const HistoricoJogo* h, const GeradorAleatorio* gerador);
+int carregarHistorico(HistoricoJogo* h, const char* caminho, GeradorAleatorio* gerador);
+
+#endif
@@ -0,0 +1,697 @@
+/* war_jogo.c
+   Implementação das regras do nível mestre: missões, ataque e contadores.
+   Separado de nivel-mestre.c para que o simulador em lote reutilize a mesma lógica.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "war_dados.h"
+#include "war_eventos.h"
+#include "war_jogo.h"
+#include "war_metricas.h"
+#include "war_reducao.h"
+#include "war_regras.h"
+
+RegistroCores registroCores;
+
+/* Definição de missões (cada string começa com um id e '|' para facilitar verificação) */
+char* missoesDisponiveis[] = {
+    "1|Conquistar 3 territorios",                       // id 1
+    "2|Eliminar todas as tropas da cor Vermelho",       // id 2 (note: cor usada "Vermelho")
+    "3|Controlar todos os territorios",                 // id 3
+    "4|Ter ao menos 10 tropas no total",                // id 4
+    "5|Conquistar o territorio Fortaleza"               // id 5 (alvo: "Fortaleza")
+};
+const int totalMissoesDisponiveis = sizeof(missoesDisponiveis) / sizeof(missoesDisponiveis[0]);
+
+const DefinicaoMissao definicoesMissoes[] = {
+    {1, MISSAO_CONQUISTAR_TERRITORIOS, NULL, 3},
+    {2, MISSAO_ELIMINAR_COR, "Vermelho", 0},
+    {3, MISSAO_CONTROLAR_TODOS, NULL, 0},
+    {4, MISSAO_ACUMULAR_TROPAS, NULL, 10},
+    {5, MISSAO_CONQUISTAR_TERRITORIO, "Fortaleza", 0}
+};
+const int totalDefinicoesMissoes = sizeof(definicoesMissoes) / sizeof(definicoesMissoes[0]);
+
+static int resolverAtaque(int idxAtq, const char* nomeAtq, int* donoAtq, int* tropasAtq,
+                          int idxDef, const char* nomeDef, int* donoDef, int* tropasDef, GeradorAleatorio* g);
+static void aplicarDiferencaAtaque(EstadoJogo* estado, int idxAtq, int idxDef,
+                                   int donoAtq, int tropasAtq, int donoDef, int tropasDef, int comEventos);
+
+/* ----------------------- Implementação ----------------------- */
+
+/* Devolve o id da cor, registrando-a se ainda não existir.
+   Nomes maiores que MAX_COR-1 são truncados. Retorna -1 se o registro estiver cheio. */
+int registrarCor(const char* cor) {
+    int id = buscarCor(cor);
+    if (id >= 0) return id;
+    if (registroCores.total >= MAX_CORES) return -1;
+    id = registroCores.total++;
+    strncpy(registroCores.nomes[id], cor, MAX_COR - 1);
+    registroCores.nomes[id][MAX_COR - 1] = '\0';
+    return id;
+}
+
+/* Devolve o id de uma cor já registrada, ou -1. */
+int buscarCor(const char* cor) {
+    for (int i = 0; i < registroCores.total; ++i) {
+        METRICA_CONTAR(CONTADOR_COMPARACOES_TEXTO);
+        if (strncmp(registroCores.nomes[i], cor, MAX_COR - 1) == 0) return i;
+    }
+    return -1;
+}
+
+const char* nomeDaCor(int id) {
+    if (id < 0 || id >= registroCores.total) return "?";
+    return registroCores.nomes[id];
+}
+
+/* Sorteia uma missão do vetor missoes[] e copia para destino usando strcpy.
+   Supõe-se que 'destino' já foi alocado com espaço suficiente. */
+void atribuirMissao(char* destino, char* missoes[], int totalMissoes) {
+    int idx = rand() % totalMissoes;
+    strcpy(destino, missoes[idx]);
+}
+
+/* Igual a atribuirMissao, mas sorteia com um gerador próprio (seguro entre threads). */
+void atribuirMissaoComGerador(char* destino, char* missoes[], int totalMissoes, GeradorAleatorio* g) {
+    int idx = geradorIntervalo(g, totalMissoes);
+    strcpy(destino, missoes[idx]);
+}
+
+/* Extrai o id numérico de uma missão no formato "id|descrição" (0 se inválida). */
+int idDaMissao(const char* missao) {
+    const char* sep = strchr(missao, '|');
+    if (!sep) return 0;
+    return atoi(missao);
+}
+
+/* Devolve a string da missão com o id dado em missoesDisponiveis, ou NULL. */
+const char* missaoPorId(int id) {
+    for (int i = 0; i < totalMissoesDisponiveis; ++i) {
+        if (idDaMissao(missoesDisponiveis[i]) == id) return missoesDisponiveis[i];
+    }
+    return NULL;
+}
+
+/* Verifica se a missão (string com formato "id|descrição") foi cumprida.
+   Retorna 1 se cumprida, 0 caso contrário.
+   Recebe também o id da cor do jogador para verificar objetivos relacionados ao jogador. */
+int verificarMissao(char* missao, Territorio* mapa, int tamanho, int donoJogador) {
+    METRICA_CONTAR(CONTADOR_VERIFICACOES_MISSAO);
+    int id = 0;
+    char descricao[200];
+    // separa id e descrição (ex: "1|Conquistar 3 territorios")
+    char* sep = strchr(missao, '|');
+    if (!sep) return 0;
+    int len_id = sep - missao;
+    char id_str[10] = {0};
+    strncpy(id_str, missao, len_id);
+    id = atoi(id_str);
+    strcpy(descricao, sep + 1);
+
+    // Implementação simples para cada id de missão
+    switch (id) {
+        case 1: { // Conquistar 3 territórios (ter >= 3 territórios)
+            int cnt = contarTerritoriosDoJogador(mapa, tamanho, donoJogador);
+            if (cnt >= 3) return 1;
+            return 0;
+        }
+        case 2: { // Eliminar todas as tropas da cor Vermelha (exemplo: 'Vermelho')
+            int vermelho = buscarCor("Vermelho");
+            if (vermelho < 0) return 1; // cor nunca existiu no jogo
+            int existe = 0;
+            for (int i = 0; i < tamanho; ++i) {
+                if (mapa[i].dono == vermelho && mapa[i].tropas > 0) {
+                    existe = 1; break;
+                }
+            }
+            return !existe; // true se não existir tropas vermelhas
+        }
+        case 3: { // Controlar todos os territórios (vencer o jogo)
+            int cnt = contarTerritoriosDoJogador(mapa, tamanho, donoJogador);
+            return (cnt == tamanho);
+        }
+        case 4: { // Ter ao menos 10 tropas no total
+            int total = somarTropasDoJogador(mapa, tamanho, donoJogador);
+            return (total >= 10);
+        }
+        case 5: { // Conquistar o território "Território X" (exemplo)
+            // vamos extrair um nome esperado depois do texto, mas para simplicidade,
+            // assumimos que missão 5 pede um território fixo "Fortaleza"
+            const char* alvo = "Fortaleza";
+            for (int i = 0; i < tamanho; ++i) {
+                if (mapa[i].dono != donoJogador) continue;
+                METRICA_CONTAR(CONTADOR_COMPARACOES_TEXTO);
+                if (strcmp(mapa[i].nome, alvo) == 0) return 1;
+            }
+            return 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+/* Exibe a missão (passagem por valor do ponteiro const char*). */
+void exibirMissao(const char* missao) {
+    char* sep = strchr(missao, '|');
+    if (sep) {
+        printf("Sua missão: %s\n", sep + 1);
+    } else {
+        printf("Sua missão: %s\n", missao);
+    }
+}
+
+/* Simulação do ataque entre territorios.
+   Usa rand() para rolagem (1..6) para atacante e defensor.
+   Se atacante vence (soma maior), transfere cor e metade das tropas ao defensor.
+   Caso perca, atacante perde 1 tropa. */
+void atacar(Territorio* atacante, Territorio* defensor) {
+    atacarComGerador(atacante, defensor, NULL);
+}
+
+/* Mesmo ataque, rolando os dados com o gerador 'g' (ou rand() se g for NULL). */
+void atacarComGerador(Territorio* atacante, Territorio* defensor, GeradorAleatorio* g) {
+    if (!atacante || !defensor) return;
+    resolverAtaque(-1, atacante->nome, &atacante->dono, &atacante->tropas,
+                   -1, defensor->nome, &defensor->dono, &defensor->tropas, g);
+}
+
+/* Mesmo ataque entre os territórios idxAtq e idxDef do mapa em colunas.
+   Devolve os dados rolados como (atacante << 4) | defensor, ou 0 se o ataque
+   não pôde ser feito. */
+int atacarNoMapa(Mapa* mapa, int idxAtq, int idxDef, GeradorAleatorio* g) {
+    return resolverAtaque(idxAtq, nomeDoTerritorio(mapa, idxAtq), &mapa->dono[idxAtq], &mapa->tropas[idxAtq],
+                          idxDef, nomeDoTerritorio(mapa, idxDef), &mapa->dono[idxDef], &mapa->tropas[idxDef], g);
+}
+
+/* Regras do ataque sobre os campos de cada lado, sem depender de como o mapa
+   é guardado (vetor de Territorio ou Mapa em colunas). A batalha segue a
+   regra compilada (war_regras.h); na conquista o atacante, já descontadas
+   as perdas, transfere metade das tropas. Cada resultado vira um evento do
+   diário ativo (war_eventos.h); sem diário nada é montado. */
+static int resolverAtaque(int idxAtq, const char* nomeAtq, int* donoAtq, int* tropasAtq,
+                          int idxDef, const char* nomeDef, int* donoDef, int* tropasDef, GeradorAleatorio* g) {
+    METRICA_CONTAR(CONTADOR_ATAQUES_TENTADOS);
+    if (*donoAtq == *donoDef || *tropasAtq < MIN_TROPAS_ATAQUE) {
+        METRICA_CONTAR(CONTADOR_ATAQUES_REJEITADOS);
+        if (eventosAtivos(NIVEL_EVENTOS_BATALHA)) {
+            Evento e = {EVENTO_ATAQUE_INVALIDO, idxAtq, idxDef, nomeAtq, nomeDef, *donoAtq, *donoDef, 0, 0,
+                        *tropasAtq, *tropasDef,
+                        *donoAtq == *donoDef ? INVALIDO_MESMO_DONO : INVALIDO_SEM_TROPAS};
+            emitirEvento(&e);
+        }
+        return 0;
+    }
+
+    ResultadoBatalha r = batalhar(g, *tropasAtq, *tropasDef);
+    int rollA = r.dadoAtacante, rollD = r.dadoDefensor;
+    int perdas = WAR_REGRAS == REGRAS_1X1 ? 0 : (r.perdasAtacante << 16) | r.perdasDefensor;
+    if (r.conquista) {
+        // atacante vence: transfere cor e metade das tropas (arredonda para baixo)
+        METRICA_CONTAR(CONTADOR_ATAQUES_VENCIDOS);
+        *tropasAtq -= r.perdasAtacante;
+        int transfer = *tropasAtq / 2;
+        if (transfer == 0) transfer = 1; // garante ao menos 1 tropa transferida
+        int donoAnterior = *donoDef;
+        *donoDef = *donoAtq;
+        *tropasDef = transfer;
+        *tropasAtq -= transfer;
+        if (*tropasAtq < 0) *tropasAtq = 0;
+        if (eventosAtivos(NIVEL_EVENTOS_PARTIDA)) {
+            Evento e = {EVENTO_BATALHA, idxAtq, idxDef, nomeAtq, nomeDef, *donoAtq, donoAnterior, rollA, rollD,
+                        *tropasAtq, *tropasDef, perdas};
+            emitirEvento(&e);
+            e.tipo = EVENTO_CONQUISTA;
+            e.valor = transfer;
+            emitirEvento(&e);
+        }
+    } else {
+        // atacante perde 1 tropa (nas clássicas, os pares perdidos de cada lado)
+        METRICA_CONTAR(CONTADOR_ATAQUES_PERDIDOS);
+        *tropasAtq -= r.perdasAtacante;
+        if (*tropasAtq < 0) *tropasAtq = 0;
+        *tropasDef -= r.perdasDefensor;
+        if (eventosAtivos(NIVEL_EVENTOS_BATALHA)) {
+            Evento e = {EVENTO_BATALHA, idxAtq, idxDef, nomeAtq, nomeDef, *donoAtq, *donoDef, rollA, rollD,
+                        *tropasAtq, *tropasDef, perdas};
+            emitirEvento(&e);
+        }
+    }
+    return (rollA << 4) | rollD;
+}
+
+/* A tabela do mapa é montada em um buffer e escrita com um fwrite a cada
+   TAMANHO_TABELA_MAPA bytes, em vez de um printf por linha. */
+#define TAMANHO_TABELA_MAPA 8192
+
+typedef struct {
+    size_t usados;
+    char texto[TAMANHO_TABELA_MAPA];
+} TabelaMapa;
+
+static void iniciarTabelaMapa(TabelaMapa* t) {
+    static const char cabecalho[] = "\nMapa atual:\n"
+                                    "Idx | Nome                 | Cor       | Tropas\n"
+                                    "----+----------------------+-----------+-------\n";
+    memcpy(t->texto, cabecalho, sizeof(cabecalho) - 1);
+    t->usados = sizeof(cabecalho) - 1;
+}
+
+static void linhaTabelaMapa(TabelaMapa* t, int i, const char* nome, int dono, int tropas) {
+    if (t->usados + 128 > sizeof(t->texto)) {
+        fwrite(t->texto, 1, t->usados, stdout);
+        t->usados = 0;
+    }
+    int n = snprintf(t->texto + t->usados, 128, "%3d | %-20s | %-9s | %5d\n", i, nome, nomeDaCor(dono), tropas);
+    if (n > 0) t->usados += n < 128 ? (size_t) n : 127;
+}
+
+static void encerrarTabelaMapa(TabelaMapa* t) {
+    t->texto[t->usados++] = '\n';
+    fwrite(t->texto, 1, t->usados, stdout);
+}
+
+/* Exibe o mapa com nome, cor e tropas de cada território. */
+void exibirMapa(Territorio* mapa, int tamanho) {
+    TabelaMapa t;
+    iniciarTabelaMapa(&t);
+    for (int i = 0; i < tamanho; ++i) linhaTabelaMapa(&t, i, mapa[i].nome, mapa[i].dono, mapa[i].tropas);
+    encerrarTabelaMapa(&t);
+}
+
+/* Mesma tabela de exibirMapa, lendo o mapa em colunas. */
+void exibirMapaColunar(const Mapa* mapa) {
+    TabelaMapa t;
+    iniciarTabelaMapa(&t);
+    for (int i = 0; i < mapa->tamanho; ++i)
+        linhaTabelaMapa(&t, i, nomeDoTerritorio(mapa, i), mapa->dono[i], mapa->tropas[i]);
+    encerrarTabelaMapa(&t);
+}
+
+/* Libera a memória das missões dos jogadores (vetor de strings alocadas) e do mapa */
+void liberarMemoria(Territorio* mapa, int tamanho, char** missoesJogadores, int numJogadores) {
+    if (mapa) free(mapa);
+    if (missoesJogadores) {
+        for (int i = 0; i < numJogadores; ++i) {
+            if (missoesJogadores[i]) free(missoesJogadores[i]);
+        }
+        free(missoesJogadores);
+    }
+}
+
+/* Contadores auxiliares */
+int contarTerritoriosDoJogador(Territorio* mapa, int tamanho, int donoJogador) {
+    int cnt = 0;
+    for (int i = 0; i < tamanho; ++i) {
+        if (mapa[i].dono == donoJogador) cnt++;
+    }
+    return cnt;
+}
+int somarTropasDoJogador(Territorio* mapa, int tamanho, int donoJogador) {
+    int soma = 0;
+    for (int i = 0; i < tamanho; ++i) {
+        if (mapa[i].dono == donoJogador) soma += mapa[i].tropas;
+    }
+    return soma;
+}
+int existeTerritorioComNome(Territorio* mapa, int tamanho, const char* nome) {
+    for (int i = 0; i < tamanho; ++i) {
+        METRICA_CONTAR(CONTADOR_COMPARACOES_TEXTO);
+        if (strcmp(mapa[i].nome, nome) == 0) return 1;
+    }
+    return 0;
+}
+
+/* Preenche o mapa de demonstração com NUM_TERRITORIOS_PADRAO territórios,
+   registrando as cores usadas. */
+void inicializarMapaPadrao(Territorio* mapa) {
+    int vermelho = registrarCor("Vermelho"), azul = registrarCor("Azul");
+    int verde = registrarCor("Verde"), amarelo = registrarCor("Amarelo");
+    strcpy(mapa[0].nome, "Fortaleza"); mapa[0].dono = vermelho; mapa[0].tropas = 3;
+    strcpy(mapa[1].nome, "Colina");     mapa[1].dono = azul;     mapa[1].tropas = 2;
+    strcpy(mapa[2].nome, "Planalto");   mapa[2].dono = vermelho; mapa[2].tropas = 4;
+    strcpy(mapa[3].nome, "Vale");       mapa[3].dono = verde;    mapa[3].tropas = 1;
+    strcpy(mapa[4].nome, "Costa");      mapa[4].dono = azul;     mapa[4].tropas = 3;
+    strcpy(mapa[5].nome, "Pântano");    mapa[5].dono = amarelo;  mapa[5].tropas = 2;
+}
+
+/* Converte um vetor de Territorio para o mapa em colunas (uma única alocação,
+   ou uma reserva na arena da partida se 'arena' não for NULL). */
+int criarMapaDeTerritorios(Mapa* mapa, const Territorio* territorios, int tamanho, ArenaJogo* arena) {
+    size_t bytesNomes = 0;
+    for (int i = 0; i < tamanho; ++i) bytesNomes += strlen(territorios[i].nome) + 1;
+    if (!(arena ? criarMapaNaArena(mapa, tamanho, bytesNomes, arena) : criarMapa(mapa, tamanho, bytesNomes)))
+        return 0;
+    for (int i = 0; i < tamanho; ++i) {
+        definirNomeTerritorio(mapa, i, territorios[i].nome);
+        mapa->dono[i] = territorios[i].dono;
+        mapa->tropas[i] = territorios[i].tropas;
+    }
+    return 1;
+}
+
+/* Lê um cenário em texto (war_csv.h) de 'f', registrando as cores, e monta o
+   mapa em colunas com uma única alocação do tamanho exato. Enquanto lê, os
+   territórios vão para vetores temporários que dobram de tamanho, então a
+   entrada pode vir de um pipe. Retorna 0 com 'erro' preenchido se alguma
+   linha for inválida, se não houver territórios ou se faltar memória. */
+int importarMapaCsv(FILE* f, Mapa* mapa, ErroImportacao* erro) {
+    LeitorCsv leitor;
+    int capacidade = 1024, total = 0;
+    size_t capacidadeNomes = 16 * 1024, bytesNomes = 0;
+    int* donos = (int*) malloc(sizeof(int) * capacidade);
+    int* tropas = (int*) malloc(sizeof(int) * capacidade);
+    char* nomes = (char*) malloc(capacidadeNomes);
+    METRICA_SOMAR(CONTADOR_ALOCACOES, 3);
+    int ok = donos && tropas && nomes && abrirLeitorCsv(&leitor, f);
+    if (!ok) {
+        free(donos); free(tropas); free(nomes);
+        erro->linha = 0;
+        strcpy(erro->mensagem, "falta de memória");
+        return 0;
+    }
+
+    TerritorioCsv t;
+    int r;
+    while ((r = lerTerritorioCsv(&leitor, &t, erro)) == 1) {
+        if (t.tamanhoNome >= MAX_NOME || t.tamanhoCor >= MAX_COR) {
+            erro->linha = t.linha;
+            snprintf(erro->mensagem, sizeof(erro->mensagem), "nome (max %d) ou cor (max %d) longos demais",
+                     MAX_NOME - 1, MAX_COR - 1);
+            r = -1;
+            break;
+        }
+        int dono = registrarCor(t.cor);
+        if (dono < 0) {
+            erro->linha = t.linha;
+            snprintf(erro->mensagem, sizeof(erro->mensagem), "mais de %d cores", MAX_CORES);
+            r = -1;
+            break;
+        }
+        if (total == capacidade) {
+            METRICA_SOMAR(CONTADOR_ALOCACOES, 2);
+            int* d = (int*) realloc(donos, sizeof(int) * capacidade * 2);
+            if (d) donos = d;
+            int* tr = d ? (int*) realloc(tropas, sizeof(int) * capacidade * 2) : NULL;
+            if (tr) tropas = tr;
+            if (!tr) {
+                erro->linha = t.linha;
+                strcpy(erro->mensagem, "falta de memória");
+                r = -1;
+                break;
+            }
+            capacidade *= 2;
+        }
+        if (bytesNomes + t.tamanhoNome + 1 > capacidadeNomes) {
+            METRICA_CONTAR(CONTADOR_ALOCACOES);
+            char* n = (char*) realloc(nomes, capacidadeNomes * 2);
+            if (!n) {
+                erro->linha = t.linha;
+                strcpy(erro->mensagem, "falta de memória");
+                r = -1;
+                break;
+            }
+            nomes = n;
+            capacidadeNomes *= 2;
+        }
+        donos[total] = dono;
+        tropas[total] = t.tropas;
+        memcpy(nomes + bytesNomes, t.nome, t.tamanhoNome + 1);
+        bytesNomes += t.tamanhoNome + 1;
+        total++;
+    }
+    fecharLeitorCsv(&leitor);
+
+    if (r == 0 && total == 0) {
+        erro->linha = 0;
+        strcpy(erro->mensagem, "nenhum território no cenário");
+        r = -1;
+    }
+    if (r == 0 && !criarMapa(mapa, total, bytesNomes)) {
+        erro->linha = 0;
+        strcpy(erro->mensagem, "falta de memória");
+        r = -1;
+    }
+    if (r == 0) {
+        memcpy(mapa->dono, donos, sizeof(int) * total);
+        memcpy(mapa->tropas, tropas, sizeof(int) * total);
+        const char* nome = nomes;
+        for (int i = 0; i < total; ++i) {
+            definirNomeTerritorio(mapa, i, nome);
+            nome += strlen(nome) + 1;
+        }
+    }
+    free(donos);
+    free(tropas);
+    free(nomes);
+    return r == 0;
+}
+
+/* Fronteiras do mapa de demonstração:
+   Fortaleza-Colina, Fortaleza-Planalto, Colina-Planalto, Colina-Costa,
+   Planalto-Vale, Vale-Costa, Vale-Pântano, Costa-Pântano. */
+int criarGrafoPadrao(GrafoMapa* grafo) {
+    static const Fronteira fronteiras[] = {
+        {0, 1}, {0, 2}, {1, 2}, {1, 4}, {2, 3}, {3, 4}, {3, 5}, {4, 5}
+    };
+    return criarGrafo(grafo, NUM_TERRITORIOS_PADRAO, fronteiras, sizeof(fronteiras) / sizeof(fronteiras[0]));
+}
+
+/* ----------------------- Estado com agregados incrementais ----------------------- */
+
+/* Prepara o estado de uma partida sobre 'mapa' e calcula os agregados com uma
+   única varredura. Alvos são registrados depois, por compilarMissao(). */
+void iniciarEstadoJogo(EstadoJogo* estado, Mapa* mapa, const GrafoMapa* grafo, GeradorAleatorio* g) {
+    estado->mapa = mapa;
+    estado->gerador = g;
+    estado->grafo = grafo;
+    estado->numAlvos = 0;
+    recalcularAgregados(estado);
+}
+
+/* Marca um território como alvo de missão, já ligando o bit do dono atual,
+   e devolve o número do seu bit (ou -1 se já houver MAX_ALVOS alvos). */
+int registrarAlvo(EstadoJogo* estado, int idxTerritorio) {
+    for (int k = 0; k < estado->numAlvos; ++k) {
+        if (estado->idxAlvos[k] == idxTerritorio) return k;
+    }
+    if (estado->numAlvos >= MAX_ALVOS) return -1;
+    int k = estado->numAlvos++;
+    estado->idxAlvos[k] = idxTerritorio;
+    int dono = estado->mapa->dono[idxTerritorio];
+    if (dono >= 0 && dono < MAX_CORES) estado->agregados.alvos[dono] |= 1u << k;
+    return k;
+}
+
+/* Recalcula todos os agregados varrendo o mapa uma vez para todas as cores
+   (reduzirPorDono escolhe a versão vetorial suportada pela CPU). */
+void recalcularAgregados(EstadoJogo* estado) {
+    AgregadosJogo* ag = &estado->agregados;
+    const Mapa* mapa = estado->mapa;
+    memset(ag, 0, sizeof(*ag));
+    reduzirPorDono(mapa, registroCores.total, ag->territorios, ag->tropas);
+    for (int k = 0; k < estado->numAlvos; ++k) {
+        int dono = mapa->dono[estado->idxAlvos[k]];
+        if (dono >= 0 && dono < MAX_CORES) ag->alvos[dono] |= 1u << k;
+    }
+}
+
+/* Confere os agregados incrementais contra uma recontagem completa do mapa.
+   Retorna 1 se baterem. */
+int validarAgregados(const EstadoJogo* estado) {
+    int territorios[MAX_CORES];
+    long long tropas[MAX_CORES];
+    reduzirPorDono(estado->mapa, registroCores.total, territorios, tropas);
+    for (int d = 0; d < registroCores.total; ++d) {
+        if (territorios[d] != estado->agregados.territorios[d] || tropas[d] != estado->agregados.tropas[d])
+            return 0;
+    }
+    return 1;
+}
+
+/* Executa o ataque no mapa e aplica aos agregados apenas a diferença causada
+   pelo ataque nos dois territórios envolvidos. Devolve os dados como atacarNoMapa. */
+int atacarNoEstado(EstadoJogo* estado, int idxAtq, int idxDef) {
+    Mapa* mapa = estado->mapa;
+    int donoAtq = mapa->dono[idxAtq], tropasAtq = mapa->tropas[idxAtq];
+    int donoDef = mapa->dono[idxDef], tropasDef = mapa->tropas[idxDef];
+
+    int dados = atacarNoMapa(mapa, idxAtq, idxDef, estado->gerador);
+    aplicarDiferencaAtaque(estado, idxAtq, idxDef, donoAtq, tropasAtq, donoDef, tropasDef, 1);
+    return dados;
+}
+
+/* Ataca repetidamente até conquistar o defensor ou o atacante ficar com menos
+   de MIN_TROPAS_ATAQUE tropas, e devolve 1 se conquistou.
+
+   Com gerador, a sequência inteira é resolvida de forma fechada: cada batalha
+   falha (derrota ou empate) com probabilidade 21/36 e custa 1 tropa, então o
+   número de falhas antes da primeira vitória é geométrico e sai de um único
+   sorteio (sortearFalhasAteVitoria). Sem gerador, ou nas regras clássicas
+   (war_regras.h), em que a chance de cada rodada depende das tropas, resolve
+   ataque por ataque. */
+int investirNoEstado(EstadoJogo* estado, int idxAtq, int idxDef) {
+    Mapa* mapa = estado->mapa;
+    int donoAtq = mapa->dono[idxAtq], tropasAtq = mapa->tropas[idxAtq];
+    int donoDef = mapa->dono[idxDef], tropasDef = mapa->tropas[idxDef];
+    if (donoAtq == donoDef || tropasAtq < MIN_TROPAS_ATAQUE) return 0;
+
+    if (!estado->gerador || WAR_REGRAS != REGRAS_1X1) {
+        while (mapa->dono[idxDef] == donoDef && mapa->tropas[idxAtq] >= MIN_TROPAS_ATAQUE)
+            atacarNoEstado(estado, idxAtq, idxDef);
+        return mapa->dono[idxDef] != donoDef;
+    }
+
+    int falhasPermitidas = tropasAtq - MIN_TROPAS_ATAQUE + 1;
+    int falhas = sortearFalhasAteVitoria(estado->gerador, falhasPermitidas);
+    mapa->tropas[idxAtq] -= falhas;
+    if (falhas < falhasPermitidas) {
+        int transfer = mapa->tropas[idxAtq] / 2;
+        if (transfer == 0) transfer = 1;
+        mapa->dono[idxDef] = donoAtq;
+        mapa->tropas[idxDef] = transfer;
+        mapa->tropas[idxAtq] -= transfer;
+    }
+    if (eventosAtivos(NIVEL_EVENTOS_PARTIDA)) {
+        Evento e = {EVENTO_INVESTIDA, idxAtq, idxDef, nomeDoTerritorio(mapa, idxAtq), nomeDoTerritorio(mapa, idxDef),
+                    donoAtq, mapa->dono[idxDef], 0, 0, mapa->tropas[idxAtq], mapa->tropas[idxDef], falhas};
+        emitirEvento(&e);
+        if (falhas < falhasPermitidas) {
+            e.tipo = EVENTO_CONQUISTA;
+            e.valor = mapa->tropas[idxDef];
+            emitirEvento(&e);
+        }
+    }
+    aplicarDiferencaAtaque(estado, idxAtq, idxDef, donoAtq, tropasAtq, donoDef, tropasDef, 1);
+    return falhas < falhasPermitidas;
+}
+
+/* Grava valores já conhecidos nos dois territórios de um ataque (as tropas do
+   atacante, o dono e as tropas do defensor) e corrige os agregados pela
+   diferença, sem rolar dados nem emitir eventos. É o que desfaz e refaz as
+   ações do histórico (war_historico.h) sem copiar o mapa. */
+void definirTerritoriosNoEstado(EstadoJogo* estado, int idxAtq, int tropasAtq, int idxDef, int donoDef, int tropasDef) {
+    Mapa* mapa = estado->mapa;
+    int tropasAtqAntes = mapa->tropas[idxAtq];
+    int donoDefAntes = mapa->dono[idxDef], tropasDefAntes = mapa->tropas[idxDef];
+    mapa->tropas[idxAtq] = tropasAtq;
+    mapa->dono[idxDef] = donoDef;
+    mapa->tropas[idxDef] = tropasDef;
+    aplicarDiferencaAtaque(estado, idxAtq, idxDef, mapa->dono[idxAtq], tropasAtqAntes, donoDefAntes, tropasDefAntes, 0);
+}
+
+/* Leva aos agregados a diferença entre os valores de antes de um ataque e o
+   mapa atual, olhando apenas os dois territórios envolvidos. */
+static void aplicarDiferencaAtaque(EstadoJogo* estado, int idxAtq, int idxDef,
+                                   int donoAtq, int tropasAtq, int donoDef, int tropasDef, int comEventos) {
+    const Mapa* mapa = estado->mapa;
+    AgregadosJogo* ag = &estado->agregados;
+    ag->tropas[donoAtq] += mapa->tropas[idxAtq] - tropasAtq;
+    int novoDono = mapa->dono[idxDef];
+    if (novoDono == donoDef) {
+        ag->tropas[donoDef] += mapa->tropas[idxDef] - tropasDef;
+        return;
+    }
+    // conquista: o território troca de dono
+    if (--ag->territorios[donoDef] == 0 && comEventos && eventosAtivos(NIVEL_EVENTOS_PARTIDA)) {
+        Evento e = {EVENTO_ELIMINACAO, idxAtq, idxDef, nomeDoTerritorio(mapa, idxAtq), nomeDoTerritorio(mapa, idxDef),
+                    novoDono, donoDef, 0, 0, mapa->tropas[idxAtq], mapa->tropas[idxDef], 0};
+        emitirEvento(&e);
+    }
+    ag->territorios[novoDono]++;
+    ag->tropas[donoDef] -= tropasDef;
+    ag->tropas[novoDono] += mapa->tropas[idxDef];
+    for (int k = 0; k < estado->numAlvos; ++k) {
+        if (estado->idxAlvos[k] == idxDef) {
+            ag->alvos[donoDef] &= ~(1u << k);
+            ag->alvos[novoDono] |= 1u << k;
+            break;
+        }
+    }
+}
+
+/* Indica se o defensor está na fronteira do atacante (sempre verdade sem grafo). */
+int fazemFronteira(const EstadoJogo* estado, int idxAtq, int idxDef) {
+    if (idxAtq == idxDef) return 0;
+    return !estado->grafo || saoVizinhos(estado->grafo, idxAtq, idxDef);
+}
+
+/* Escreve em 'saida' os ataques legais do jogador: atacante próprio com pelo
+   menos MIN_TROPAS_ATAQUE tropas contra um vizinho de outra cor. Não aloca
+   nada; para de escrever ao encher 'capacidade' e devolve quantos escreveu.
+   Com o grafo, 'capacidade' = inicio[tamanho] sempre basta. */
+int gerarAtaquesLegais(const EstadoJogo* estado, int donoJogador, Ataque* saida, int capacidade) {
+    const int* dono = estado->mapa->dono;
+    const int* tropas = estado->mapa->tropas;
+    const GrafoMapa* grafo = estado->grafo;
+    int tamanho = estado->mapa->tamanho;
+    int total = 0;
+    for (int i = 0; i < tamanho; ++i) {
+        if (dono[i] != donoJogador || tropas[i] < MIN_TROPAS_ATAQUE) continue;
+        if (grafo) {
+            for (int k = grafo->inicio[i]; k < grafo->inicio[i + 1]; ++k) {
+                int v = grafo->vizinhos[k];
+                if (dono[v] == donoJogador) continue;
+                if (total == capacidade) return total;
+                saida[total++] = (Ataque){i, v};
+            }
+        } else {
+            for (int v = 0; v < tamanho; ++v) {
+                if (dono[v] == donoJogador) continue;
+                if (total == capacidade) return total;
+                saida[total++] = (Ataque){i, v};
+            }
+        }
+    }
+    return total;
+}
+
+/* Interpreta a missão "id|descrição" uma única vez: procura a definição do id
+   e resolve os nomes de cor e território para ids do registro e bits de alvo.
+   Retorna 0 se o id não estiver no catálogo. */
+int compilarMissao(Missao* destino, const char* missao, EstadoJogo* estado) {
+    memset(destino, 0, sizeof(*destino));
+    destino->corAlvo = -1;
+    destino->bitAlvo = -1;
+    destino->id = idDaMissao(missao);
+
+    const DefinicaoMissao* def = NULL;
+    for (int i = 0; i < totalDefinicoesMissoes; ++i) {
+        if (definicoesMissoes[i].id == destino->id) { def = &definicoesMissoes[i]; break; }
+    }
+    if (!def) return 0;
+
+    destino->tipo = def->tipo;
+    destino->limite = def->limite;
+    if (def->tipo == MISSAO_ELIMINAR_COR) {
+        destino->corAlvo = buscarCor(def->parametro);
+    } else if (def->tipo == MISSAO_CONQUISTAR_TERRITORIO) {
+        int idx = buscarTerritorio(estado->mapa, def->parametro);
+        if (idx >= 0) destino->bitAlvo = registrarAlvo(estado, idx);
+    }
+    return 1;
+}
+
+/* Mesmo resultado de verificarMissao, mas lendo os agregados do estado em O(1),
+   sem nenhuma operação de string. */
+int verificarMissaoNoEstado(const Missao* missao, const EstadoJogo* estado, int donoJogador) {
+    METRICA_CONTAR(CONTADOR_VERIFICACOES_MISSAO);
+    const AgregadosJogo* ag = &estado->agregados;
+    switch (missao->tipo) {
+        case MISSAO_CONQUISTAR_TERRITORIOS:
+            return ag->territorios[donoJogador] >= missao->limite;
+        case MISSAO_ELIMINAR_COR: // cor que nunca existiu no jogo conta como eliminada
+            return missao->corAlvo < 0 || ag->tropas[missao->corAlvo] == 0;
+        case MISSAO_CONTROLAR_TODOS:
+            return ag->territorios[donoJogador] == estado->mapa->tamanho;
+        case MISSAO_ACUMULAR_TROPAS:
+            return ag->tropas[donoJogador] >= missao->limite;
+        case MISSAO_CONQUISTAR_TERRITORIO:
+            return missao->bitAlvo >= 0 && (ag->alvos[donoJogador] & (1u << missao->bitAlvo)) != 0;
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,137 @@
+/* war_jogo.h
+   Regras do nível mestre compartilhadas entre o jogo interativo (nivel-mestre.c)
+   e o simulador em lote (war_simulador.c).
+*/
+
+#ifndef WAR_JOGO_H
+#define WAR_JOGO_H
+
+#include "war_aleatorio.h"
+#include "war_csv.h"
+#include "war_grafo.h"
+#include "war_mapa.h"
+
+#define MAX_NOME 30
+#define MAX_COR 10
+#define MAX_MISSAO 200
+#define MAX_CORES 32
+#define MIN_TROPAS_ATAQUE 1  // tropas mínimas para um território atacar (jogo, gerador de ataques e simulador)
+
+typedef struct {
+    char nome[30];
+    int dono;     // id da cor do dono no registro de cores (ex: "Vermelho", "Azul")
+    int tropas;
+} Territorio;
+
+/* Registro de cores: cada cor recebe um id pequeno uma única vez, na preparação
+   do jogo. Os laços quentes comparam e atribuem só o id; o nome é usado apenas
+   para exibição. */
+typedef struct {
+    char nomes[MAX_CORES][MAX_COR];
+    int total;
+} RegistroCores;
+
+extern RegistroCores registroCores;
+
+#define MAX_ALVOS 32
+
+/* Contadores por dono mantidos incrementalmente a cada ataque, para que a
+   verificação de missões no fim do turno seja O(1) em vez de varrer o mapa. */
+typedef struct {
+    int territorios[MAX_CORES];   // quantidade de territórios de cada cor
+    long long tropas[MAX_CORES];  // tropas vivas de cada cor
+    uint32_t alvos[MAX_CORES];    // bit k ligado: a cor controla o alvo k
+} AgregadosJogo;
+
+/* Estado de uma partida: o mapa (em colunas), o gerador usado nos dados e os
+   agregados. Alvos são territórios citados por missões (ex: "Fortaleza"). */
+typedef struct {
+    Mapa* mapa;
+    GeradorAleatorio* gerador;    // NULL = usa rand()
+    const GrafoMapa* grafo;       // fronteiras; NULL = qualquer território ataca qualquer outro
+    int idxAlvos[MAX_ALVOS];
+    int numAlvos;
+    AgregadosJogo agregados;
+} EstadoJogo;
+
+/* Par (atacante, defensor) produzido pelo gerador de ataques legais. */
+typedef struct {
+    int atacante;
+    int defensor;
+} Ataque;
+
+/* Tipos de missão. Cada missão do catálogo é um destes tipos com parâmetros. */
+typedef enum {
+    MISSAO_INVALIDA = 0,
+    MISSAO_CONQUISTAR_TERRITORIOS,  // ter ao menos 'limite' territórios
+    MISSAO_ELIMINAR_COR,            // a cor 'corAlvo' não ter mais tropas
+    MISSAO_CONTROLAR_TODOS,         // ter todos os territórios do mapa
+    MISSAO_ACUMULAR_TROPAS,         // ter ao menos 'limite' tropas no total
+    MISSAO_CONQUISTAR_TERRITORIO    // controlar o território alvo
+} TipoMissao;
+
+/* Missão já interpretada: a string "id|descrição" é lida uma vez, em
+   compilarMissao(), e os nomes de cor e território viram ids e índices. */
+typedef struct {
+    int id;                 // id no catálogo (para relatórios)
+    TipoMissao tipo;
+    int corAlvo;            // MISSAO_ELIMINAR_COR: id da cor, ou -1 se a cor não existe
+    int bitAlvo;            // MISSAO_CONQUISTAR_TERRITORIO: bit em AgregadosJogo.alvos, ou -1
+    int limite;             // MISSAO_CONQUISTAR_TERRITORIOS / MISSAO_ACUMULAR_TROPAS
+} Missao;
+
+/* Catálogo padrão de missões no formato "id|descrição". */
+extern char* missoesDisponiveis[];
+extern const int totalMissoesDisponiveis;
+
+/* Definição de cada id do catálogo: tipo e parâmetros por nome. Uma missão
+   nova só precisa de uma linha aqui e outra em missoesDisponiveis. */
+typedef struct {
+    int id;
+    TipoMissao tipo;
+    const char* parametro;  // nome da cor ou do território alvo (ou NULL)
+    int limite;
+} DefinicaoMissao;
+
+extern const DefinicaoMissao definicoesMissoes[];
+extern const int totalDefinicoesMissoes;
+
+/* ----------------------- Assinaturas das funções ----------------------- */
+int registrarCor(const char* cor);
+int buscarCor(const char* cor);
+const char* nomeDaCor(int id);
+void atribuirMissao(char* destino, char* missoes[], int totalMissoes);
+void atribuirMissaoComGerador(char* destino, char* missoes[], int totalMissoes, GeradorAleatorio* g);
+int idDaMissao(const char* missao);
+const char* missaoPorId(int id);
+int verificarMissao(char* missao, Territorio* mapa, int tamanho, int donoJogador);
+void exibirMissao(const char* missao); // passagem por valor para exibir (const char*)
+void atacar(Territorio* atacante, Territorio* defensor);
+void atacarComGerador(Territorio* atacante, Territorio* defensor, GeradorAleatorio* g);
+int atacarNoMapa(Mapa* mapa, int idxAtq, int idxDef, GeradorAleatorio* g);
+void exibirMapa(Territorio* mapa, int tamanho);
+void exibirMapaColunar(const Mapa* mapa);
+void liberarMemoria(Territorio* mapa, int tamanho, char** missoesJogadores, int numJogadores);
+int contarTerritoriosDoJogador(Territorio* mapa, int tamanho, int donoJogador);
+int somarTropasDoJogador(Territorio* mapa, int tamanho, int donoJogador);
+int existeTerritorioComNome(Territorio* mapa, int tamanho, const char* nome);
+void inicializarMapaPadrao(Territorio* mapa);
+int criarMapaDeTerritorios(Mapa* mapa, const Territorio* territorios, int tamanho, ArenaJogo* arena);
+int importarMapaCsv(FILE* f, Mapa* mapa, ErroImportacao* erro);
+int criarGrafoPadrao(GrafoMapa* grafo);
+
+void iniciarEstadoJogo(EstadoJogo* estado, Mapa* mapa, const GrafoMapa* grafo, GeradorAleatorio* g);
+int registrarAlvo(EstadoJogo* estado, int idxTerritorio);
+void recalcularAgregados(EstadoJogo* estado);
+int validarAgregados(const EstadoJogo* estado);
+int atacarNoEstado(EstadoJogo* estado, int idxAtq, int idxDef);
+int investirNoEstado(EstadoJogo* estado, int idxAtq, int idxDef);
+void definirTerritoriosNoEstado(EstadoJogo* estado, int idxAtq, int tropasAtq, int idxDef, int donoDef, int tropasDef);
+int fazemFronteira(const EstadoJogo* estado, int idxAtq, int idxDef);
+int gerarAtaquesLegais(const EstadoJogo* estado, int donoJogador, Ataque* saida, int capacidade);
+int compilarMissao(Missao* destino, const char* missao, EstadoJogo* estado);
+int verificarMissaoNoEstado(const Missao* missao, const EstadoJogo* estado, int donoJogador);
+
+#define NUM_TERRITORIOS_PADRAO 6
+
+#endif
@@ -0,0 +1,127 @@
+/* war_mapa.c
+   Criação e varreduras do mapa em colunas.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "war_arena.h"
+#include "war_mapa.h"
+#include "war_metricas.h"
+
+/* Bytes do bloco de um mapa: vetores de dono, tropas, início dos nomes e a
+   tabela de nomes com 'capacidadeNomes' bytes (mais o '\0' final). */
+size_t bytesDoMapa(int tamanho, size_t capacidadeNomes) {
+    return sizeof(int) * ((size_t) tamanho * 3 + 1) + capacidadeNomes + 1;
+}
+
+/* Distribui o bloco zerado entre os vetores do mapa. */
+static void montarMapa(Mapa* mapa, int tamanho, size_t capacidadeNomes, char* bloco) {
+    mapa->tamanho = tamanho;
+    mapa->dono = (int*) bloco;
+    mapa->tropas = mapa->dono + tamanho;
+    mapa->inicioNome = mapa->tropas + tamanho;
+    mapa->nomes = bloco + sizeof(int) * ((size_t) tamanho * 3 + 1);
+    mapa->capacidadeNomes = capacidadeNomes;
+    // nomes ainda não definidos apontam para o '\0' extra depois da tabela
+    for (int i = 0; i <= tamanho; ++i) mapa->inicioNome[i] = (int) capacidadeNomes;
+}
+
+/* Reserva numa única alocação os vetores de dono, tropas, início dos nomes e a
+   tabela de nomes (com 'capacidadeNomes' bytes). Donos e tropas começam em 0;
+   os nomes são gravados depois, em ordem, com definirNomeTerritorio. */
+int criarMapa(Mapa* mapa, int tamanho, size_t capacidadeNomes) {
+    memset(mapa, 0, sizeof(*mapa));
+    if (tamanho < 0) return 0;
+    METRICA_CONTAR(CONTADOR_ALOCACOES);
+    char* bloco = (char*) calloc(1, bytesDoMapa(tamanho, capacidadeNomes));
+    if (!bloco) return 0;
+    montarMapa(mapa, tamanho, capacidadeNomes, bloco);
+    mapa->bloco = bloco;
+    return 1;
+}
+
+/* Mesmo mapa de criarMapa, com o bloco reservado na arena: bloco fica NULL e
+   liberarMapa não libera nada (o bloco vai embora com a arena). */
+int criarMapaNaArena(Mapa* mapa, int tamanho, size_t capacidadeNomes, ArenaJogo* arena) {
+    memset(mapa, 0, sizeof(*mapa));
+    if (tamanho < 0) return 0;
+    char* bloco = (char*) reservarNaArena(arena, bytesDoMapa(tamanho, capacidadeNomes));
+    if (!bloco) return 0;
+    montarMapa(mapa, tamanho, capacidadeNomes, bloco);
+    return 1;
+}
+
+/* Grava o nome do território i na tabela. Os nomes precisam ser definidos na
+   ordem 0, 1, 2...; retorna 0 se fora de ordem ou se a tabela estiver cheia. */
+int definirNomeTerritorio(Mapa* mapa, int i, const char* nome) {
+    if (i != mapa->nomesDefinidos || i >= mapa->tamanho) return 0;
+    size_t usado = i == 0 ? 0 : (size_t) mapa->inicioNome[i];
+    size_t len = strlen(nome);
+    if (usado + len + 1 > mapa->capacidadeNomes) return 0;
+    memcpy(mapa->nomes + usado, nome, len + 1);
+    mapa->inicioNome[i] = (int) usado;
+    mapa->inicioNome[i + 1] = (int) (usado + len + 1);
+    mapa->nomesDefinidos++;
+    return 1;
+}
+
+/* Cria em 'destino' vetores próprios de dono e tropas (uma alocação) com os
+   valores de 'origem', apontando para a mesma tabela de nomes. Usado pelo
+   simulador: cada thread joga no seu mapa, mas os nomes nunca mudam. */
+int copiarMapaCompartilhandoNomes(Mapa* destino, const Mapa* origem) {
+    return copiarMapaNaArena(destino, origem, NULL);
+}
+
+/* Como copiarMapaCompartilhandoNomes, com dono e tropas reservados na arena
+   (ou numa alocação própria, se 'arena' for NULL). */
+int copiarMapaNaArena(Mapa* destino, const Mapa* origem, ArenaJogo* arena) {
+    size_t bytes = sizeof(int) * 2 * (origem->tamanho > 0 ? origem->tamanho : 1);
+    *destino = *origem;
+    if (!arena) METRICA_CONTAR(CONTADOR_ALOCACOES);
+    int* bloco = (int*) (arena ? reservarNaArena(arena, bytes) : malloc(bytes));
+    if (!bloco) {
+        memset(destino, 0, sizeof(*destino));
+        return 0;
+    }
+    destino->dono = bloco;
+    destino->tropas = bloco + origem->tamanho;
+    destino->bloco = arena ? NULL : bloco;
+    restaurarMapa(destino, origem);
+    return 1;
+}
+
+/* Volta dono e tropas de 'destino' para os valores de 'origem' (mesmo tamanho). */
+void restaurarMapa(Mapa* destino, const Mapa* origem) {
+    memcpy(destino->dono, origem->dono, sizeof(int) * origem->tamanho);
+    memcpy(destino->tropas, origem->tropas, sizeof(int) * origem->tamanho);
+}
+
+void liberarMapa(Mapa* mapa) {
+    if (!mapa) return;
+    free(mapa->bloco);
+    memset(mapa, 0, sizeof(*mapa));
+}
+
+int buscarTerritorio(const Mapa* mapa, const char* nome) {
+    for (int i = 0; i < mapa->tamanho; ++i) {
+        METRICA_CONTAR(CONTADOR_COMPARACOES_TEXTO);
+        if (strcmp(nomeDoTerritorio(mapa, i), nome) == 0) return i;
+    }
+    return -1;
+}
+
+/* Contadores: percorrem só o vetor de donos (e o de tropas, na soma). */
+int contarTerritoriosNoMapa(const Mapa* mapa, int donoJogador) {
+    int cnt = 0;
+    for (int i = 0; i < mapa->tamanho; ++i) cnt += (mapa->dono[i] == donoJogador);
+    return cnt;
+}
+
+long long somarTropasNoMapa(const Mapa* mapa, int donoJogador) {
+    long long soma = 0;
+    for (int i = 0; i < mapa->tamanho; ++i) {
+        if (mapa->dono[i] == donoJogador) soma += mapa->tropas[i];
+    }
+    return soma;
+}
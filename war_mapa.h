@@ -0,0 +1,43 @@
+/* war_mapa.h
+   Mapa em colunas (structure of arrays): o dono e as tropas de cada território
+   ficam em dois vetores contíguos de int, e os nomes numa tabela de strings
+   separada. As varreduras (contagens, somas, geração de ataques) leem só os
+   8 bytes quentes por território, sem arrastar os nomes para o cache.
+*/
+
+#ifndef WAR_MAPA_H
+#define WAR_MAPA_H
+
+#include <stddef.h>
+
+#include "war_arena.h"
+
+typedef struct {
+    int tamanho;
+    int* dono;          // id da cor do dono de cada território
+    int* tropas;        // tropas de cada território
+    int* inicioNome;    // tamanho + 1 posições: nome i começa em nomes + inicioNome[i]
+    char* nomes;        // tabela de nomes terminados em '\0'
+    size_t capacidadeNomes;
+    int nomesDefinidos; // quantos nomes já foram gravados (em ordem)
+    void* bloco;        // alocação única que guarda tudo acima (NULL se não for dono, ex.: arena)
+} Mapa;
+
+size_t bytesDoMapa(int tamanho, size_t capacidadeNomes);
+int criarMapa(Mapa* mapa, int tamanho, size_t capacidadeNomes);
+int criarMapaNaArena(Mapa* mapa, int tamanho, size_t capacidadeNomes, ArenaJogo* arena);
+int definirNomeTerritorio(Mapa* mapa, int i, const char* nome);
+int copiarMapaCompartilhandoNomes(Mapa* destino, const Mapa* origem);
+int copiarMapaNaArena(Mapa* destino, const Mapa* origem, ArenaJogo* arena);
+void restaurarMapa(Mapa* destino, const Mapa* origem);
+void liberarMapa(Mapa* mapa);
+
+int buscarTerritorio(const Mapa* mapa, const char* nome);
+int contarTerritoriosNoMapa(const Mapa* mapa, int donoJogador);
+long long somarTropasNoMapa(const Mapa* mapa, int donoJogador);
+
+static inline const char* nomeDoTerritorio(const Mapa* mapa, int i) {
+    return mapa->nomes + mapa->inicioNome[i];
+}
+
+#endif
@@ -0,0 +1,244 @@
+/* war_mcts.c
+   Busca em árvore Monte Carlo sobre as regras de war_jogo.c.
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "war_eventos.h"
+#include "war_mcts.h"
+#include "war_metricas.h"
+
+#define ITERACOES_POR_CONSULTA_RELOGIO 64
+
+/* Contexto de uma jogada: o estado real e os jogadores da partida. */
+typedef struct {
+    JogadorMcts* j;
+    EstadoJogo* estado;
+    const Missao* missoes;
+    const int* donos;
+    int numJogadores;
+    int jogadorAtual;
+} BuscaMcts;
+
+ConfigMcts configMctsPadrao(void) {
+    ConfigMcts cfg = {0.1, 0, 64, 1.4, 1 << 18};
+    return cfg;
+}
+
+int criarJogadorMcts(JogadorMcts* j, const ConfigMcts* cfg, const EstadoJogo* estado, uint64_t semente) {
+    int tamanho = estado->mapa->tamanho;
+    j->cfg = *cfg;
+    if (j->cfg.profundidadeMaxima < 1) j->cfg.profundidadeMaxima = 1;
+    j->capacidadeAtaques = estado->grafo ? estado->grafo->inicio[tamanho] : tamanho * (tamanho - 1);
+    if (j->capacidadeAtaques < 1) j->capacidadeAtaques = 1;
+    j->pool.capacidade = j->cfg.capacidadeNos > 1 ? j->cfg.capacidadeNos : 1;
+    j->pool.usados = 0;
+    METRICA_SOMAR(CONTADOR_ALOCACOES, 3);
+    j->pool.nos = (NoMcts*) malloc(sizeof(NoMcts) * j->pool.capacidade);
+    j->ataques = (Ataque*) malloc(sizeof(Ataque) * j->capacidadeAtaques);
+    j->caminho = (int*) malloc(sizeof(int) * (j->cfg.profundidadeMaxima + 1));
+    int historicoOk = criarHistorico(&j->historico, semente);
+    geradorIniciar(&j->gerador, semente);
+    j->iteracoes = 0;
+    j->segundos = 0.0;
+    if (!j->pool.nos || !j->ataques || !j->caminho || !historicoOk) {
+        liberarJogadorMcts(j);
+        return 0;
+    }
+    return 1;
+}
+
+void liberarJogadorMcts(JogadorMcts* j) {
+    free(j->pool.nos);
+    free(j->ataques);
+    free(j->caminho);
+    liberarHistorico(&j->historico);
+    j->pool.nos = NULL;
+    j->ataques = NULL;
+    j->caminho = NULL;
+}
+
+static double segundosDesde(const struct timespec* inicio) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double) (agora.tv_sec - inicio->tv_sec) + (agora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+/* Primeiro jogador (na ordem do laço de turnos) com a missão cumprida, ou -1. */
+static int vencedorNoEstado(const BuscaMcts* b) {
+    for (int k = 0; k < b->numJogadores; ++k) {
+        if (verificarMissaoNoEstado(&b->missoes[k], b->estado, b->donos[k])) return k;
+    }
+    return -1;
+}
+
+/* O ataque do nó ainda é possível nesta amostra dos dados? (passar sempre é) */
+static int jogadaPossivel(const Mapa* mapa, const NoMcts* no, int dono) {
+    if (no->atacante < 0) return 1;
+    return mapa->dono[no->atacante] == dono && mapa->tropas[no->atacante] >= MIN_TROPAS_ATAQUE &&
+           mapa->dono[no->defensor] != dono;
+}
+
+/* Cria de uma vez os filhos do nó: um por ataque legal e um para passar.
+   Retorna 0 se o pool não comporta todos. */
+static int expandir(JogadorMcts* j, int indice, const EstadoJogo* estado, int dono) {
+    int total = gerarAtaquesLegais(estado, dono, j->ataques, j->capacidadeAtaques);
+    PoolNosMcts* pool = &j->pool;
+    if (total + 1 > pool->capacidade - pool->usados) return 0;
+    NoMcts* filhos = &pool->nos[pool->usados];
+    for (int k = 0; k < total; ++k) {
+        NoMcts filho = {j->ataques[k].atacante, j->ataques[k].defensor, -1, 0, 0, 0.0f};
+        filhos[k] = filho;
+    }
+    NoMcts passar = {-1, -1, -1, 0, 0, 0.0f};
+    filhos[total] = passar;
+    pool->nos[indice].primeiroFilho = pool->usados;
+    pool->nos[indice].numFilhos = total + 1;
+    pool->usados += total + 1;
+    return 1;
+}
+
+/* UCT entre os filhos possíveis nesta amostra; filhos nunca visitados primeiro. */
+static int selecionarFilho(const JogadorMcts* j, const NoMcts* no, const Mapa* mapa, int dono) {
+    double logPai = log((double) no->visitas + 1.0);
+    int melhor = -1;
+    double melhorValor = -1.0;
+    for (int k = 0; k < no->numFilhos; ++k) {
+        int indice = no->primeiroFilho + k;
+        const NoMcts* filho = &j->pool.nos[indice];
+        if (!jogadaPossivel(mapa, filho, dono)) continue;
+        if (filho->visitas == 0) return indice;
+        double valor = filho->vitorias / filho->visitas + j->cfg.exploracao * sqrt(logPai / filho->visitas);
+        if (valor > melhorValor) {
+            melhorValor = valor;
+            melhor = indice;
+        }
+    }
+    return melhor;
+}
+
+/* Vitória vale 1 e derrota 0. Sem vencedor (empate ou fim da profundidade),
+   metade da fração dos territórios dos jogadores que são de 'jogador', para
+   que dominar o mapa conte, mas nunca tanto quanto cumprir a missão. */
+static float recompensa(const BuscaMcts* b, int vencedor, int jogador) {
+    if (vencedor >= 0) return vencedor == jogador ? 1.0f : 0.0f;
+    const AgregadosJogo* ag = &b->estado->agregados;
+    int soma = 0;
+    for (int k = 0; k < b->numJogadores; ++k) soma += ag->territorios[b->donos[k]];
+    return soma > 0 ? 0.5f * ag->territorios[b->donos[jogador]] / soma : 0.0f;
+}
+
+/* Aplica uma jogada da simulação (idxAtq < 0 = passar) e atualiza os passes seguidos. */
+static void jogar(BuscaMcts* b, int turno, int idxAtq, int idxDef, int* passesSeguidos) {
+    if (idxAtq < 0) {
+        (*passesSeguidos)++;
+        return;
+    }
+    atacarComHistorico(&b->j->historico, b->estado, turno, idxAtq, idxDef);
+    *passesSeguidos = 0;
+}
+
+/* Uma iteração: seleção, expansão, simulação aleatória e retropropagação;
+   no fim as jogadas são desfeitas e o estado volta ao da raiz. */
+static void iterar(BuscaMcts* b) {
+    JogadorMcts* j = b->j;
+    NoMcts* nos = j->pool.nos;
+    const Mapa* mapa = b->estado->mapa;
+    int profundidade = j->cfg.profundidadeMaxima;
+    int tamanhoCaminho = 1;
+    int turno = 0, passesSeguidos = 0, vencedor = -1, terminou = 0;
+    j->caminho[0] = 0;
+
+    // seleção e expansão
+    int indice = 0;
+    while (turno < profundidade) {
+        int dono = b->donos[(b->jogadorAtual + turno) % b->numJogadores];
+        if (nos[indice].primeiroFilho < 0 && !expandir(j, indice, b->estado, dono)) break;
+        int filho = selecionarFilho(j, &nos[indice], mapa, dono);
+        if (filho < 0) break;
+        jogar(b, turno, nos[filho].atacante, nos[filho].defensor, &passesSeguidos);
+        j->caminho[tamanhoCaminho++] = filho;
+        indice = filho;
+        turno++;
+        vencedor = vencedorNoEstado(b);
+        if (vencedor >= 0 || passesSeguidos >= b->numJogadores) {
+            terminou = 1;
+            break;
+        }
+        if (nos[filho].visitas == 0) break; // nó novo: o resto da partida é aleatório
+    }
+
+    // simulação: ataques legais sorteados, passando só quando não há nenhum
+    while (!terminou && turno < profundidade) {
+        int dono = b->donos[(b->jogadorAtual + turno) % b->numJogadores];
+        int total = gerarAtaquesLegais(b->estado, dono, j->ataques, j->capacidadeAtaques);
+        if (total > 0) {
+            const Ataque* a = &j->ataques[geradorIntervalo(&j->gerador, total)];
+            jogar(b, turno, a->atacante, a->defensor, &passesSeguidos);
+        } else {
+            jogar(b, turno, -1, -1, &passesSeguidos);
+        }
+        turno++;
+        vencedor = vencedorNoEstado(b);
+        terminou = vencedor >= 0 || passesSeguidos >= b->numJogadores;
+    }
+
+    // retropropagação: o nó do passo k foi escolhido pelo jogador do turno k - 1
+    nos[0].visitas++;
+    for (int k = 1; k < tamanhoCaminho; ++k) {
+        NoMcts* no = &nos[j->caminho[k]];
+        no->visitas++;
+        no->vitorias += recompensa(b, vencedor, (b->jogadorAtual + k - 1) % b->numJogadores);
+    }
+
+    while (desfazerAcao(&j->historico, b->estado) >= 0) {}
+}
+
+int escolherJogadaMcts(JogadorMcts* j, EstadoJogo* estado, const Missao* missoes, const int* donos,
+                       int numJogadores, int jogadorAtual, int* idxAtq, int* idxDef) {
+    BuscaMcts b = {j, estado, missoes, donos, numJogadores, jogadorAtual};
+    NoMcts raiz = {-1, -1, -1, 0, 0, 0.0f};
+    j->pool.nos[0] = raiz;
+    j->pool.usados = 1;
+    j->historico.total = 0;
+
+    // as simulações usam o gerador do jogador e não geram eventos
+    GeradorAleatorio* geradorPartida = estado->gerador;
+    DiarioEventos* diario = diarioAtivo;
+    estado->gerador = &j->gerador;
+    usarDiarioEventos(NULL);
+
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    long iteracoes = 0;
+    for (;;) {
+        iterar(&b);
+        ++iteracoes;
+        if (j->cfg.maxIteracoes > 0 && iteracoes >= j->cfg.maxIteracoes) break;
+        if (iteracoes % ITERACOES_POR_CONSULTA_RELOGIO == 0 && j->cfg.segundosPorJogada > 0.0 &&
+            segundosDesde(&inicio) >= j->cfg.segundosPorJogada)
+            break;
+        if (j->cfg.maxIteracoes <= 0 && j->cfg.segundosPorJogada <= 0.0) break;
+    }
+    j->iteracoes = iteracoes;
+    j->segundos = segundosDesde(&inicio);
+
+    estado->gerador = geradorPartida;
+    usarDiarioEventos(diario);
+
+    // a jogada mais visitada é a mais robusta
+    const NoMcts* r = &j->pool.nos[0];
+    int melhor = -1;
+    for (int k = 0; k < r->numFilhos; ++k) {
+        const NoMcts* filho = &j->pool.nos[r->primeiroFilho + k];
+        if (melhor < 0 || filho->visitas > j->pool.nos[melhor].visitas) melhor = r->primeiroFilho + k;
+    }
+    if (melhor < 0 || j->pool.nos[melhor].atacante < 0) return 0;
+    *idxAtq = j->pool.nos[melhor].atacante;
+    *idxDef = j->pool.nos[melhor].defensor;
+    return 1;
+}
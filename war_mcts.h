@@ -0,0 +1,71 @@
+/* war_mcts.h
+   Jogador do computador por busca em árvore Monte Carlo (UCT).
+
+   Cada iteração parte do estado real da partida, desce a árvore escolhendo
+   ataques pelo UCT, expande um nó e termina a partida com jogadas aleatórias.
+   As transições são as mesmas do jogo (atacarNoEstado) e o fim é o mesmo
+   teste de missões (verificarMissaoNoEstado), na ordem do laço de turnos.
+   Os dados são sorteados de novo a cada iteração ("open loop"): um nó
+   representa a sequência de ataques escolhidos, não um mapa; um filho cujo
+   ataque deixou de ser possível naquela amostra é pulado.
+
+   Nada é copiado: as jogadas da iteração entram num histórico próprio
+   (war_historico.h) e são desfeitas por diferença no fim da iteração.
+   Os nós vêm de um pool contíguo, zerado (usados = 0) a cada jogada; os
+   filhos de um nó ficam lado a lado, criados de uma vez na expansão.
+*/
+
+#ifndef WAR_MCTS_H
+#define WAR_MCTS_H
+
+#include "war_aleatorio.h"
+#include "war_historico.h"
+#include "war_jogo.h"
+
+typedef struct {
+    double segundosPorJogada;   // orçamento de tempo por jogada (0 = só maxIteracoes)
+    long maxIteracoes;          // 0 = só o tempo
+    int profundidadeMaxima;     // turnos simulados por iteração, a partir da jogada atual
+    double exploracao;          // constante C do UCT
+    int capacidadeNos;          // tamanho do pool de nós
+} ConfigMcts;
+
+typedef struct {
+    int atacante;       // ataque que leva a este nó; -1 = passar o turno
+    int defensor;
+    int primeiroFilho;  // índice no pool; -1 = ainda não expandido
+    int numFilhos;
+    int visitas;
+    float vitorias;     // do ponto de vista de quem escolheu este nó
+} NoMcts;
+
+typedef struct {
+    NoMcts* nos;
+    int capacidade;
+    int usados;
+} PoolNosMcts;
+
+typedef struct {
+    ConfigMcts cfg;
+    PoolNosMcts pool;
+    HistoricoJogo historico;    // jogadas da iteração em curso, para desfazer
+    Ataque* ataques;            // vetor de trabalho para gerarAtaquesLegais
+    int capacidadeAtaques;
+    int* caminho;               // nós visitados na iteração (profundidadeMaxima + 1)
+    GeradorAleatorio gerador;   // dados e jogadas aleatórias das simulações
+    long iteracoes;             // da última jogada
+    double segundos;            // da última jogada
+} JogadorMcts;
+
+/* Valores padrão: 100 ms por jogada, 64 turnos por simulação, C = 1.4. */
+ConfigMcts configMctsPadrao(void);
+int criarJogadorMcts(JogadorMcts* j, const ConfigMcts* cfg, const EstadoJogo* estado, uint64_t semente);
+void liberarJogadorMcts(JogadorMcts* j);
+
+/* Escolhe a jogada do jogador 'jogadorAtual' (índice em donos/missoes).
+   O estado é usado nas simulações e devolvido exatamente como veio.
+   Retorna 0 para passar o turno. */
+int escolherJogadaMcts(JogadorMcts* j, EstadoJogo* estado, const Missao* missoes, const int* donos,
+                       int numJogadores, int jogadorAtual, int* idxAtq, int* idxDef);
+
+#endif
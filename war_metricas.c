@@ -0,0 +1,146 @@
+/* war_metricas.c
+   Armazenamento e relatório das métricas (só com -DWAR_METRICAS).
+*/
+
+#define _DEFAULT_SOURCE
+
+#include "war_metricas.h"
+
+#ifdef WAR_METRICAS
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TAMANHO_RELATORIO 2048
+
+MetricasJogo metricasJogo;
+
+static const char* nomesContadores[NUM_CONTADORES] = {
+    "ataques tentados", "ataques rejeitados", "ataques vencidos", "ataques perdidos",
+    "verificações de missão", "comparações de texto", "alocações"
+};
+static const char* nomesFases[NUM_FASES] = {"entrada", "ataque", "missão", "desenho"};
+
+/* Marco inicial para converter ciclos em tempo: ciclos e nanossegundos
+   decorridos desde a instalação dão a frequência do contador. */
+static uint64_t ciclosInicio;
+static uint64_t nanossegundosInicio;
+
+static uint64_t nanossegundosAgora(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000ULL + (uint64_t) t.tv_nsec;
+}
+
+#if !defined(__x86_64__) && !defined(__i386__)
+uint64_t lerCiclos(void) {
+    return nanossegundosAgora();
+}
+#endif
+
+/* Montagem do texto sem stdio (o relatório pode sair de um tratador de sinal). */
+typedef struct {
+    char texto[TAMANHO_RELATORIO];
+    size_t usados;
+} TextoRelatorio;
+
+static void acrescentarTexto(TextoRelatorio* t, const char* s) {
+    size_t n = strlen(s);
+    if (n > sizeof(t->texto) - t->usados) n = sizeof(t->texto) - t->usados;
+    memcpy(t->texto + t->usados, s, n);
+    t->usados += n;
+}
+
+/* Número alinhado à direita em 'largura' colunas. */
+static void acrescentarNumero(TextoRelatorio* t, uint64_t v, int largura) {
+    char digitos[24];
+    int n = 0;
+    do {
+        digitos[n++] = (char) ('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    for (int i = n; i < largura; ++i) acrescentarTexto(t, " ");
+    char s[24];
+    for (int i = 0; i < n; ++i) s[i] = digitos[n - 1 - i];
+    s[n] = '\0';
+    acrescentarTexto(t, s);
+}
+
+/* Nome seguido de espaços até 'largura' colunas (conta caracteres, não bytes UTF-8). */
+static void acrescentarRotulo(TextoRelatorio* t, const char* s, int largura) {
+    acrescentarTexto(t, s);
+    int colunas = 0;
+    for (const char* p = s; *p; ++p) {
+        if (((unsigned char) *p & 0xC0) != 0x80) colunas++;
+    }
+    for (int i = colunas; i < largura; ++i) acrescentarTexto(t, " ");
+}
+
+void escreverRelatorioMetricas(int fd) {
+    TextoRelatorio t;
+    t.usados = 0;
+    uint64_t ciclos = lerCiclos() - ciclosInicio;
+    uint64_t nanossegundos = nanossegundosAgora() - nanossegundosInicio;
+    double nsPorCiclo = ciclos > 0 ? (double) nanossegundos / (double) ciclos : 0.0;
+
+    acrescentarTexto(&t, "\n=== Métricas ===\n");
+    for (int c = 0; c < NUM_CONTADORES; ++c) {
+        acrescentarRotulo(&t, nomesContadores[c], 24);
+        acrescentarNumero(&t, __atomic_load_n(&metricasJogo.contadores[c], __ATOMIC_RELAXED), 14);
+        acrescentarTexto(&t, "\n");
+    }
+    acrescentarTexto(&t, "fase             vezes        ciclos   ciclos/vez  tempo (µs)\n");
+    for (int f = 0; f < NUM_FASES; ++f) {
+        uint64_t vezes = __atomic_load_n(&metricasJogo.vezes[f], __ATOMIC_RELAXED);
+        uint64_t ciclosFase = __atomic_load_n(&metricasJogo.ciclos[f], __ATOMIC_RELAXED);
+        acrescentarRotulo(&t, nomesFases[f], 10);
+        acrescentarNumero(&t, vezes, 12);
+        acrescentarNumero(&t, ciclosFase, 14);
+        acrescentarNumero(&t, vezes ? ciclosFase / vezes : 0, 13);
+        acrescentarNumero(&t, (uint64_t) (ciclosFase * nsPorCiclo / 1000.0), 12);
+        acrescentarTexto(&t, "\n");
+    }
+    acrescentarTexto(&t, "tempo total (µs) ");
+    acrescentarNumero(&t, nanossegundos / 1000, 21);
+    acrescentarTexto(&t, "\n");
+
+    size_t escritos = 0;
+    while (escritos < t.usados) {
+        ssize_t n = write(fd, t.texto + escritos, t.usados - escritos);
+        if (n <= 0) break;
+        escritos += (size_t) n;
+    }
+}
+
+static void relatarNaSaida(void) {
+    escreverRelatorioMetricas(STDERR_FILENO);
+}
+
+/* SIGUSR1 só escreve; SIGINT e SIGTERM escrevem e seguem com a ação padrão. */
+static void tratarSinal(int sinal) {
+    escreverRelatorioMetricas(STDERR_FILENO);
+    if (sinal != SIGUSR1) {
+        signal(sinal, SIG_DFL);
+        raise(sinal);
+    }
+}
+
+void instalarRelatorioMetricas(void) {
+    ciclosInicio = lerCiclos();
+    nanossegundosInicio = nanossegundosAgora();
+    atexit(relatarNaSaida);
+
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = tratarSinal;
+    acao.sa_flags = SA_RESTART; // o fgets do laço de jogo continua esperando depois do SIGUSR1
+    sigemptyset(&acao.sa_mask);
+    sigaction(SIGUSR1, &acao, NULL);
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+}
+
+#endif
@@ -0,0 +1,84 @@
+/* war_metricas.h
+   Contadores e cronômetros do laço de jogo, removidos na compilação.
+
+   Sem WAR_METRICAS definido (o padrão) todas as macros abaixo viram nada e
+   o código instrumentado é idêntico ao original. Com -DWAR_METRICAS
+   (make METRICAS=1) cada contador é um incremento atômico relaxado num
+   vetor global, e cada fase soma os ciclos lidos com rdtsc (clock_gettime
+   fora do x86) entre METRICA_INICIO e METRICA_FIM.
+
+   O relatório sai no fim do programa e a cada SIGUSR1; SIGINT e SIGTERM
+   também o escrevem antes de encerrar. Ele é montado só com write(), que
+   pode ser chamado de dentro do tratador do sinal. Os incrementos são
+   atômicos porque atacarNoMapa também roda nas threads de war_ordens e do
+   simulador; a ordem relaxada basta, já que só os totais são lidos.
+*/
+
+#ifndef WAR_METRICAS_H
+#define WAR_METRICAS_H
+
+#include <stdint.h>
+
+typedef enum {
+    CONTADOR_ATAQUES_TENTADOS = 0,
+    CONTADOR_ATAQUES_REJEITADOS,    // recusados pela validação (dono, índice, fronteira, tropas)
+    CONTADOR_ATAQUES_VENCIDOS,
+    CONTADOR_ATAQUES_PERDIDOS,
+    CONTADOR_VERIFICACOES_MISSAO,
+    CONTADOR_COMPARACOES_TEXTO,     // strcmp/strncmp em nomes de cor e território
+    CONTADOR_ALOCACOES,             // malloc/calloc/realloc
+    NUM_CONTADORES
+} ContadorMetrica;
+
+typedef enum {
+    FASE_ENTRADA = 0,   // esperando e lendo a jogada
+    FASE_ATAQUE,        // resolução do ataque (ou a escolha do computador)
+    FASE_MISSAO,        // verificação das missões no fim do turno
+    FASE_DESENHO,       // desenho do mapa
+    NUM_FASES
+} FaseMetrica;
+
+#ifdef WAR_METRICAS
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t lerCiclos(void) {
+    return __rdtsc();
+}
+#else
+uint64_t lerCiclos(void); // nanossegundos de clock_gettime
+#endif
+
+typedef struct {
+    uint64_t contadores[NUM_CONTADORES];
+    uint64_t ciclos[NUM_FASES];
+    uint64_t vezes[NUM_FASES];
+} MetricasJogo;
+
+extern MetricasJogo metricasJogo;
+
+void instalarRelatorioMetricas(void);
+void escreverRelatorioMetricas(int fd);
+
+#define METRICA_ADICIONAR(campo, n) ((void) __atomic_fetch_add(&(campo), (uint64_t) (n), __ATOMIC_RELAXED))
+#define METRICA_CONTAR(c) METRICA_ADICIONAR(metricasJogo.contadores[(c)], 1)
+#define METRICA_SOMAR(c, n) METRICA_ADICIONAR(metricasJogo.contadores[(c)], (n))
+#define METRICA_INICIO(inicio) uint64_t inicio = lerCiclos()
+#define METRICA_FIM(fase, inicio)                                               \
+    do {                                                                        \
+        METRICA_ADICIONAR(metricasJogo.ciclos[(fase)], lerCiclos() - (inicio)); \
+        METRICA_ADICIONAR(metricasJogo.vezes[(fase)], 1);                       \
+    } while (0)
+#define METRICAS_INSTALAR() instalarRelatorioMetricas()
+
+#else
+
+#define METRICA_CONTAR(c) ((void) 0)
+#define METRICA_SOMAR(c, n) ((void) 0)
+#define METRICA_INICIO(inicio) ((void) 0)
+#define METRICA_FIM(fase, inicio) ((void) 0)
+#define METRICAS_INSTALAR() ((void) 0)
+
+#endif
+
+#endif
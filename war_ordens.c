@@ -0,0 +1,274 @@
+/* war_ordens.c
+   Resolução de um lote de ordens em ondas sem conflito, repartidas entre threads.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "war_eventos.h"
+#include "war_metricas.h"
+#include "war_ordens.h"
+
+static void* executarTrabalhadorOrdens(void* arg);
+
+int criarResolvedorOrdens(ResolvedorOrdens* r, int tamanhoMapa, int capacidade, int numThreads) {
+    memset(r, 0, sizeof(*r));
+    r->tamanhoMapa = tamanhoMapa;
+    r->capacidade = capacidade > 0 ? capacidade : 1;
+    r->numThreads = numThreads > 0 ? numThreads : 1;
+    pthread_mutex_init(&r->trava, NULL);
+    METRICA_SOMAR(CONTADOR_ALOCACOES, 8);
+    r->ordens = (OrdemAtaque*) malloc(sizeof(OrdemAtaque) * r->capacidade);
+    r->resultados = (int*) malloc(sizeof(int) * r->capacidade);
+    r->referencia = (int*) malloc(sizeof(int) * r->capacidade);
+    r->ondaOrdem = (int*) malloc(sizeof(int) * r->capacidade);
+    r->porOnda = (int*) malloc(sizeof(int) * r->capacidade);
+    r->inicioOnda = (int*) malloc(sizeof(int) * (r->capacidade + 1));
+    r->ondaTerritorio = (int*) calloc(tamanhoMapa > 0 ? tamanhoMapa : 1, sizeof(int));
+    r->trabalhadores = (TrabalhadorOrdens*) aligned_alloc(64, sizeof(TrabalhadorOrdens) * r->numThreads);
+    r->threads = (pthread_t*) malloc(sizeof(pthread_t) * r->numThreads);
+    if (!r->ordens || !r->resultados || !r->referencia || !r->ondaOrdem || !r->porOnda || !r->inicioOnda ||
+        !r->ondaTerritorio || !r->trabalhadores || !r->threads) {
+        liberarResolvedorOrdens(r);
+        return 0;
+    }
+    for (int i = 0; i < r->numThreads; ++i) {
+        memset(&r->trabalhadores[i], 0, sizeof(TrabalhadorOrdens));
+        r->trabalhadores[i].r = r;
+        r->trabalhadores[i].indice = i;
+    }
+
+    // as threads esperam a trava até a barreira existir com o número de
+    // threads que de fato foram criadas
+    if (r->numThreads > 1) {
+        pthread_mutex_lock(&r->trava);
+        while (r->threadsCriadas < r->numThreads - 1 &&
+               pthread_create(&r->threads[r->threadsCriadas], NULL, executarTrabalhadorOrdens,
+                              &r->trabalhadores[r->threadsCriadas + 1]) == 0)
+            r->threadsCriadas++;
+        r->numThreads = r->threadsCriadas + 1;
+        if (r->threadsCriadas > 0) pthread_barrier_init(&r->barreira, NULL, r->numThreads);
+        pthread_mutex_unlock(&r->trava);
+    }
+    return 1;
+}
+
+void liberarResolvedorOrdens(ResolvedorOrdens* r) {
+    if (r->threadsCriadas > 0) {
+        r->encerrar = 1;
+        pthread_barrier_wait(&r->barreira);
+        for (int i = 0; i < r->threadsCriadas; ++i) pthread_join(r->threads[i], NULL);
+        pthread_barrier_destroy(&r->barreira);
+        r->threadsCriadas = 0;
+    }
+    pthread_mutex_destroy(&r->trava);
+    free(r->ordens);
+    free(r->resultados);
+    free(r->referencia);
+    free(r->ondaOrdem);
+    free(r->porOnda);
+    free(r->inicioOnda);
+    free(r->ondaTerritorio);
+    free(r->trabalhadores);
+    free(r->threads);
+    memset(r, 0, sizeof(*r));
+}
+
+void iniciarLoteOrdens(ResolvedorOrdens* r, int numJogadores, int primeiro, uint64_t semente) {
+    r->numJogadores = numJogadores < MAX_CORES ? numJogadores : MAX_CORES;
+    r->primeiro = r->numJogadores > 0 ? ((primeiro % r->numJogadores) + r->numJogadores) % r->numJogadores : 0;
+    r->semente = semente;
+    r->total = 0;
+    memset(r->inicioJogador, 0, sizeof(r->inicioJogador));
+    memset(r->ordensJogador, 0, sizeof(r->ordensJogador));
+}
+
+int entregarOrdens(ResolvedorOrdens* r, int jogador, int dono, const Ataque* ataques, int quantidade) {
+    if (jogador < 0 || jogador >= r->numJogadores || r->ordensJogador[jogador] > 0) return 0;
+    r->inicioJogador[jogador] = r->total;
+    for (int k = 0; k < quantidade && r->total < r->capacidade; ++k) {
+        const Ataque* a = &ataques[k];
+        if (a->atacante < 0 || a->atacante >= r->tamanhoMapa || a->defensor < 0 ||
+            a->defensor >= r->tamanhoMapa || a->atacante == a->defensor)
+            continue;
+        OrdemAtaque o = {a->atacante, a->defensor, dono};
+        r->ordens[r->total++] = o;
+    }
+    r->ordensJogador[jogador] = r->total - r->inicioJogador[jogador];
+    return r->ordensJogador[jogador];
+}
+
+/* Ordem de referência: a k-ésima ordem de cada jogador, em rodízio a partir de 'primeiro'. */
+static void montarReferencia(ResolvedorOrdens* r) {
+    int maiorLote = 0, s = 0;
+    for (int j = 0; j < r->numJogadores; ++j)
+        if (r->ordensJogador[j] > maiorLote) maiorLote = r->ordensJogador[j];
+    for (int k = 0; k < maiorLote; ++k) {
+        for (int q = 0; q < r->numJogadores; ++q) {
+            int j = (r->primeiro + q) % r->numJogadores;
+            if (k < r->ordensJogador[j]) r->referencia[s++] = r->inicioJogador[j] + k;
+        }
+    }
+}
+
+/* Onda de cada ordem: a seguinte à última onda que tocou um dos seus
+   territórios. Depois agrupa as posições por onda (contagem), mantendo em
+   cada onda a ordem de referência. */
+static void montarOndas(ResolvedorOrdens* r) {
+    int numOndas = 0;
+    for (int s = 0; s < r->total; ++s) {
+        const OrdemAtaque* o = &r->ordens[r->referencia[s]];
+        int ondaAtq = r->ondaTerritorio[o->atacante], ondaDef = r->ondaTerritorio[o->defensor];
+        int onda = (ondaAtq > ondaDef ? ondaAtq : ondaDef) + 1;
+        r->ondaTerritorio[o->atacante] = r->ondaTerritorio[o->defensor] = onda;
+        r->ondaOrdem[s] = onda - 1;
+        if (onda > numOndas) numOndas = onda;
+    }
+    memset(r->inicioOnda, 0, sizeof(int) * (numOndas + 1));
+    for (int s = 0; s < r->total; ++s) r->inicioOnda[r->ondaOrdem[s] + 1]++;
+    for (int w = 0; w < numOndas; ++w) r->inicioOnda[w + 1] += r->inicioOnda[w];
+    for (int s = 0; s < r->total; ++s) r->porOnda[r->inicioOnda[r->ondaOrdem[s]]++] = s;
+    for (int w = numOndas; w > 0; --w) r->inicioOnda[w] = r->inicioOnda[w - 1];
+    r->inicioOnda[0] = 0;
+    r->numOndas = numOndas;
+
+    // só os territórios tocados voltam a zero, sem varrer o mapa
+    for (int s = 0; s < r->total; ++s) {
+        const OrdemAtaque* o = &r->ordens[r->referencia[s]];
+        r->ondaTerritorio[o->atacante] = r->ondaTerritorio[o->defensor] = 0;
+    }
+}
+
+/* Gerador da ordem na posição 's' da referência. */
+static void geradorDaOrdem(const ResolvedorOrdens* r, int s, GeradorAleatorio* g) {
+    uint64_t x = r->semente + (uint64_t) s;
+    geradorIniciar(g, splitmix64(&x));
+}
+
+/* A ordem ainda pode ser cumprida no estado atual dos seus dois territórios? */
+static int ordemValida(const EstadoJogo* estado, const OrdemAtaque* o) {
+    const Mapa* m = estado->mapa;
+    return m->dono[o->atacante] == o->dono && m->tropas[o->atacante] >= MIN_TROPAS_ATAQUE &&
+           m->dono[o->defensor] != o->dono && fazemFronteira(estado, o->atacante, o->defensor);
+}
+
+/* Executa a ordem da posição 's' só no mapa; a diferença nos agregados fica
+   na da thread. Retorna 1 se a ordem foi executada. */
+static int executarOrdem(ResolvedorOrdens* r, int s, DiferencaAgregados* d) {
+    int i = r->referencia[s];
+    const OrdemAtaque* o = &r->ordens[i];
+    Mapa* m = r->estado->mapa;
+    r->resultados[i] = 0;
+    if (!ordemValida(r->estado, o)) return 0;
+
+    GeradorAleatorio g;
+    geradorDaOrdem(r, s, &g);
+    int tropasAtq = m->tropas[o->atacante];
+    int donoDef = m->dono[o->defensor], tropasDef = m->tropas[o->defensor];
+    r->resultados[i] = atacarNoMapa(m, o->atacante, o->defensor, &g);
+    d->tropas[o->dono] += m->tropas[o->atacante] - tropasAtq;
+    if (m->dono[o->defensor] == donoDef) {
+        d->tropas[donoDef] += m->tropas[o->defensor] - tropasDef;
+    } else {
+        d->territorios[donoDef]--;
+        d->territorios[o->dono]++;
+        d->tropas[donoDef] -= tropasDef;
+        d->tropas[o->dono] += m->tropas[o->defensor];
+    }
+    return 1;
+}
+
+/* A fatia da onda que cabe à thread: blocos contíguos de tamanho igual. */
+static void executarOnda(ResolvedorOrdens* r, int onda, TrabalhadorOrdens* t) {
+    int inicio = r->inicioOnda[onda];
+    long long tamanho = r->inicioOnda[onda + 1] - inicio;
+    int de = inicio + (int) (tamanho * t->indice / r->numThreads);
+    int ate = inicio + (int) (tamanho * (t->indice + 1) / r->numThreads);
+    for (int k = de; k < ate; ++k) t->executadas += executarOrdem(r, r->porOnda[k], &t->diferenca);
+}
+
+/* Uma barreira abre o lote e outra fecha cada onda, então nenhuma thread
+   começa a onda seguinte antes de todas terminarem a atual. O número de
+   ondas é lido uma vez: passada a última barreira, a thread que chama já
+   pode estar montando o lote seguinte. */
+static void* executarTrabalhadorOrdens(void* arg) {
+    TrabalhadorOrdens* t = (TrabalhadorOrdens*) arg;
+    ResolvedorOrdens* r = t->r;
+    pthread_mutex_lock(&r->trava);
+    pthread_mutex_unlock(&r->trava);
+    for (;;) {
+        pthread_barrier_wait(&r->barreira);
+        if (r->encerrar) return NULL;
+        int numOndas = r->numOndas;
+        for (int w = 0; w < numOndas; ++w) {
+            executarOnda(r, w, t);
+            pthread_barrier_wait(&r->barreira);
+        }
+    }
+}
+
+int resolverOrdens(ResolvedorOrdens* r, EstadoJogo* estado) {
+    DiarioEventos* diario = diarioAtivo;
+    usarDiarioEventos(NULL);
+    montarReferencia(r);
+    r->estado = estado;
+    for (int i = 0; i < r->numThreads; ++i) {
+        memset(&r->trabalhadores[i].diferenca, 0, sizeof(DiferencaAgregados));
+        r->trabalhadores[i].executadas = 0;
+    }
+
+    if (r->threadsCriadas > 0 && r->total >= ORDENS_MINIMAS_PARALELO) {
+        montarOndas(r);
+        pthread_barrier_wait(&r->barreira);
+        for (int w = 0; w < r->numOndas; ++w) {
+            executarOnda(r, w, &r->trabalhadores[0]);
+            pthread_barrier_wait(&r->barreira);
+        }
+    } else {
+        // uma thread só: a própria referência já respeita as dependências
+        TrabalhadorOrdens* t = &r->trabalhadores[0];
+        for (int s = 0; s < r->total; ++s) t->executadas += executarOrdem(r, s, &t->diferenca);
+    }
+
+    AgregadosJogo* ag = &estado->agregados;
+    int executadas = 0;
+    for (int i = 0; i < r->numThreads; ++i) {
+        const TrabalhadorOrdens* t = &r->trabalhadores[i];
+        executadas += t->executadas;
+        for (int d = 0; d < MAX_CORES; ++d) {
+            ag->territorios[d] += t->diferenca.territorios[d];
+            ag->tropas[d] += t->diferenca.tropas[d];
+        }
+    }
+    memset(ag->alvos, 0, sizeof(ag->alvos));
+    for (int k = 0; k < estado->numAlvos; ++k) {
+        int dono = estado->mapa->dono[estado->idxAlvos[k]];
+        if (dono >= 0 && dono < MAX_CORES) ag->alvos[dono] |= 1u << k;
+    }
+    usarDiarioEventos(diario);
+    return executadas;
+}
+
+int resolverOrdensEmSequencia(ResolvedorOrdens* r, EstadoJogo* estado) {
+    DiarioEventos* diario = diarioAtivo;
+    GeradorAleatorio* geradorPartida = estado->gerador;
+    usarDiarioEventos(NULL);
+    montarReferencia(r);
+    int executadas = 0;
+    GeradorAleatorio g;
+    estado->gerador = &g;
+    for (int s = 0; s < r->total; ++s) {
+        int i = r->referencia[s];
+        const OrdemAtaque* o = &r->ordens[i];
+        r->resultados[i] = 0;
+        if (!ordemValida(estado, o)) continue;
+        geradorDaOrdem(r, s, &g);
+        r->resultados[i] = atacarNoEstado(estado, o->atacante, o->defensor);
+        executadas++;
+    }
+    estado->gerador = geradorPartida;
+    usarDiarioEventos(diario);
+    return executadas;
+}
@@ -0,0 +1,113 @@
+/* war_ordens.h
+   Turno simultâneo: cada jogador entrega um lote de ordens de ataque e todas
+   são resolvidas de uma vez, em paralelo, no lugar de um ataque por turno.
+
+   Ordem de referência: as ordens entram em rodízio, a primeira de cada
+   jogador, depois a segunda de cada um, e assim por diante, começando pelo
+   jogador 'primeiro' do lote (quem chama o roda a cada turno, para que
+   nenhum jogador tenha sempre a vantagem). Num território disputado por
+   várias ordens, vale essa ordem. Cada ordem é validada ao ser resolvida,
+   não ao ser entregue: se o atacante caiu, ficou sem MIN_TROPAS_ATAQUE
+   tropas ou o defensor já é do mesmo dono, a ordem é descartada. Os dados
+   de cada ordem vêm de um gerador próprio, semeado pela semente do lote e
+   pela posição da ordem na referência, e não da thread que a executa.
+
+   Conflitos: uma passada pela referência põe cada ordem na onda seguinte à
+   última que tocou o seu atacante ou o seu defensor. Ordens da mesma onda
+   não têm território em comum, então comutam; as ondas são executadas em
+   sequência e cada onda é repartida entre as threads. O mapa final e os
+   resultados são os da referência (resolverOrdensEmSequencia), qualquer que
+   seja o número de threads.
+
+   As threads ficam criadas entre os lotes e esperam numa barreira; a thread
+   que chama também trabalha. Os agregados saem de diferenças acumuladas por
+   thread, sem varrer o mapa. Durante a resolução não há eventos: o diário
+   da thread que chama é suspenso, e as demais não têm diário.
+*/
+
+#ifndef WAR_ORDENS_H
+#define WAR_ORDENS_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "war_jogo.h"
+
+#define ORDENS_MINIMAS_PARALELO 256 // lotes menores são resolvidos só pela thread que chama
+
+typedef struct {
+    int atacante;
+    int defensor;
+    int dono;       // id da cor do jogador que deu a ordem
+} OrdemAtaque;
+
+/* Diferença nos agregados causada pelas ordens de uma thread. Alinhada em 64
+   bytes para que threads vizinhas não compartilhem linha de cache. */
+typedef struct {
+    _Alignas(64) int territorios[MAX_CORES];
+    long long tropas[MAX_CORES];
+} DiferencaAgregados;
+
+struct ResolvedorOrdens;
+
+typedef struct {
+    struct ResolvedorOrdens* r;
+    int indice;                 // 0 = a thread que chama
+    int executadas;
+    DiferencaAgregados diferenca;
+} TrabalhadorOrdens;
+
+typedef struct ResolvedorOrdens {
+    int capacidade;             // ordens por lote
+    int tamanhoMapa;
+    int numThreads;             // incluindo a que chama
+
+    // lote atual
+    int numJogadores;
+    int primeiro;
+    uint64_t semente;
+    int total;
+    OrdemAtaque* ordens;        // na ordem de entrega
+    int* resultados;            // por ordem entregue: dados como atacarNoMapa, 0 = descartada
+    int inicioJogador[MAX_CORES];
+    int ordensJogador[MAX_CORES];
+
+    // resolução
+    int* referencia;            // índices das ordens na ordem de referência
+    int* ondaOrdem;             // onda de cada posição da referência
+    int* porOnda;               // posições na referência, agrupadas por onda
+    int* inicioOnda;            // numOndas + 1 posições em porOnda
+    int numOndas;
+    int* ondaTerritorio;        // última onda que tocou cada território; 0 = nenhuma
+
+    // threads
+    EstadoJogo* estado;         // do lote em resolução
+    int encerrar;
+    pthread_mutex_t trava;      // segura as threads até a barreira estar pronta
+    pthread_barrier_t barreira;
+    pthread_t* threads;         // numThreads - 1
+    TrabalhadorOrdens* trabalhadores;
+    int threadsCriadas;
+} ResolvedorOrdens;
+
+int criarResolvedorOrdens(ResolvedorOrdens* r, int tamanhoMapa, int capacidade, int numThreads);
+void liberarResolvedorOrdens(ResolvedorOrdens* r);
+
+/* Começa um lote vazio de 'numJogadores' jogadores (no máximo MAX_CORES). */
+void iniciarLoteOrdens(ResolvedorOrdens* r, int numJogadores, int primeiro, uint64_t semente);
+
+/* Entrega as ordens do jogador 'jogador' (índice em [0, numJogadores)), uma
+   vez por lote. Ordens com índices fora do mapa ou atacante igual ao
+   defensor são ignoradas, assim como as que não cabem na capacidade.
+   Retorna quantas ordens entraram no lote. */
+int entregarOrdens(ResolvedorOrdens* r, int jogador, int dono, const Ataque* ataques, int quantidade);
+
+/* Resolve o lote em paralelo e corrige os agregados. O lote continua
+   entregue: pode ser resolvido de novo sobre outra cópia do estado.
+   Retorna quantas ordens foram executadas. */
+int resolverOrdens(ResolvedorOrdens* r, EstadoJogo* estado);
+
+/* Referência: as mesmas ordens, uma a uma, com atacarNoEstado. */
+int resolverOrdensEmSequencia(ResolvedorOrdens* r, EstadoJogo* estado);
+
+#endif
@@ -0,0 +1,184 @@
+/* war_reducao.c
+   Reduções por cor sobre os vetores de dono e tropas.
+
+   A versão escalar é um histograma. As versões vetoriais processam o mapa em
+   blocos que cabem no cache L1 e, para cada cor, comparam 4 (SSE2) ou 8 (AVX2)
+   donos de uma vez: a máscara da comparação conta os territórios e seleciona
+   as tropas. Cada tropa é somada em duas metades de 16 bits (t = alta * 65536
+   + baixa), o que cabe em lanes de 32 bits dentro de um bloco sem estourar;
+   as metades são juntadas em 64 bits no fim do bloco, então o resultado é
+   idêntico ao escalar.
+
+   As versões vetoriais fazem uma passada por cor sobre o bloco; com muitas
+   cores o histograma escalar fica mais rápido, e reduzirPorDono troca para
+   ele acima de MAX_DONOS_VETORIAL.
+*/
+
+#include <string.h>
+
+#include "war_reducao.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WAR_REDUCAO_X86 1
+#include <immintrin.h>
+#endif
+
+#define BLOCO_REDUCAO 2048 // 2048 * (4 + 4) bytes = 16 KiB por bloco
+#define MAX_DONOS_VETORIAL 4
+
+/* ----------------------- Escalar ----------------------- */
+
+static void reduzirEscalar(const int* dono, const int* tropas, int tamanho, int numDonos,
+                           int* territorios, long long* somas) {
+    for (int i = 0; i < tamanho; ++i) {
+        unsigned d = (unsigned) dono[i];
+        if (d >= (unsigned) numDonos) continue;
+        territorios[d]++;
+        somas[d] += tropas[i];
+    }
+}
+
+#ifdef WAR_REDUCAO_X86
+
+/* ----------------------- SSE2 ----------------------- */
+
+__attribute__((target("sse2")))
+static void reduzirSse2(const int* dono, const int* tropas, int tamanho, int numDonos,
+                        int* territorios, long long* somas) {
+    const __m128i baixo16 = _mm_set1_epi32(0xFFFF);
+    for (int base = 0; base < tamanho; base += BLOCO_REDUCAO) {
+        int fim = base + BLOCO_REDUCAO < tamanho ? base + BLOCO_REDUCAO : tamanho;
+        int fimVetor = base + ((fim - base) & ~3);
+        for (int d = 0; d < numDonos; ++d) {
+            __m128i alvo = _mm_set1_epi32(d);
+            __m128i contagem = _mm_setzero_si128();
+            __m128i somaBaixa = _mm_setzero_si128();
+            __m128i somaAlta = _mm_setzero_si128();
+            for (int i = base; i < fimVetor; i += 4) {
+                __m128i donos = _mm_loadu_si128((const __m128i*) (dono + i));
+                __m128i mascara = _mm_cmpeq_epi32(donos, alvo);
+                contagem = _mm_sub_epi32(contagem, mascara); // máscara vale -1 quando bate
+                __m128i t = _mm_and_si128(_mm_loadu_si128((const __m128i*) (tropas + i)), mascara);
+                somaBaixa = _mm_add_epi32(somaBaixa, _mm_and_si128(t, baixo16));
+                somaAlta = _mm_add_epi32(somaAlta, _mm_srai_epi32(t, 16));
+            }
+            int c[4], b[4], a[4];
+            _mm_storeu_si128((__m128i*) c, contagem);
+            _mm_storeu_si128((__m128i*) b, somaBaixa);
+            _mm_storeu_si128((__m128i*) a, somaAlta);
+            long long baixa = 0, alta = 0;
+            for (int k = 0; k < 4; ++k) {
+                territorios[d] += c[k];
+                baixa += b[k];
+                alta += a[k];
+            }
+            somas[d] += alta * 65536 + baixa;
+        }
+        reduzirEscalar(dono + fimVetor, tropas + fimVetor, fim - fimVetor, numDonos, territorios, somas);
+    }
+}
+
+/* ----------------------- AVX2 ----------------------- */
+
+__attribute__((target("avx2")))
+static void reduzirAvx2(const int* dono, const int* tropas, int tamanho, int numDonos,
+                        int* territorios, long long* somas) {
+    const __m256i baixo16 = _mm256_set1_epi32(0xFFFF);
+    for (int base = 0; base < tamanho; base += BLOCO_REDUCAO) {
+        int fim = base + BLOCO_REDUCAO < tamanho ? base + BLOCO_REDUCAO : tamanho;
+        int fimVetor = base + ((fim - base) & ~7);
+        for (int d = 0; d < numDonos; ++d) {
+            __m256i alvo = _mm256_set1_epi32(d);
+            __m256i contagem = _mm256_setzero_si256();
+            __m256i somaBaixa = _mm256_setzero_si256();
+            __m256i somaAlta = _mm256_setzero_si256();
+            for (int i = base; i < fimVetor; i += 8) {
+                __m256i donos = _mm256_loadu_si256((const __m256i*) (dono + i));
+                __m256i mascara = _mm256_cmpeq_epi32(donos, alvo);
+                contagem = _mm256_sub_epi32(contagem, mascara);
+                __m256i t = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (tropas + i)), mascara);
+                somaBaixa = _mm256_add_epi32(somaBaixa, _mm256_and_si256(t, baixo16));
+                somaAlta = _mm256_add_epi32(somaAlta, _mm256_srai_epi32(t, 16));
+            }
+            int c[8], b[8], a[8];
+            _mm256_storeu_si256((__m256i*) c, contagem);
+            _mm256_storeu_si256((__m256i*) b, somaBaixa);
+            _mm256_storeu_si256((__m256i*) a, somaAlta);
+            long long baixa = 0, alta = 0;
+            for (int k = 0; k < 8; ++k) {
+                territorios[d] += c[k];
+                baixa += b[k];
+                alta += a[k];
+            }
+            somas[d] += alta * 65536 + baixa;
+        }
+        reduzirEscalar(dono + fimVetor, tropas + fimVetor, fim - fimVetor, numDonos, territorios, somas);
+    }
+}
+
+#endif
+
+/* ----------------------- Seleção ----------------------- */
+
+int implementacaoReducaoSuportada(ImplementacaoReducao impl) {
+    switch (impl) {
+        case REDUCAO_ESCALAR:
+            return 1;
+#ifdef WAR_REDUCAO_X86
+        case REDUCAO_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case REDUCAO_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return 0;
+    }
+}
+
+/* Chamada por todas as threads (simulador e war_ordens, via iniciarEstadoJogo).
+   A escolha é lida e gravada com atômicos relaxados: duas threads podem
+   escolher ao mesmo tempo, mas chegam ao mesmo valor. */
+ImplementacaoReducao implementacaoReducaoAtiva(void) {
+    static int escolhida = -1;
+    int impl = __atomic_load_n(&escolhida, __ATOMIC_RELAXED);
+    if (impl < 0) {
+        if (implementacaoReducaoSuportada(REDUCAO_AVX2)) impl = REDUCAO_AVX2;
+        else if (implementacaoReducaoSuportada(REDUCAO_SSE2)) impl = REDUCAO_SSE2;
+        else impl = REDUCAO_ESCALAR;
+        __atomic_store_n(&escolhida, impl, __ATOMIC_RELAXED);
+    }
+    return (ImplementacaoReducao) impl;
+}
+
+const char* nomeImplementacaoReducao(ImplementacaoReducao impl) {
+    switch (impl) {
+        case REDUCAO_SSE2: return "sse2";
+        case REDUCAO_AVX2: return "avx2";
+        default: return "escalar";
+    }
+}
+
+/* Usa 'impl' se a CPU suportar; senão cai para a versão escalar. */
+void reduzirPorDonoCom(ImplementacaoReducao impl, const Mapa* mapa, int numDonos,
+                       int* territorios, long long* tropas) {
+    memset(territorios, 0, sizeof(int) * numDonos);
+    memset(tropas, 0, sizeof(long long) * numDonos);
+    if (!implementacaoReducaoSuportada(impl)) impl = REDUCAO_ESCALAR;
+    switch (impl) {
+#ifdef WAR_REDUCAO_X86
+        case REDUCAO_AVX2:
+            reduzirAvx2(mapa->dono, mapa->tropas, mapa->tamanho, numDonos, territorios, tropas);
+            break;
+        case REDUCAO_SSE2:
+            reduzirSse2(mapa->dono, mapa->tropas, mapa->tamanho, numDonos, territorios, tropas);
+            break;
+#endif
+        default:
+            reduzirEscalar(mapa->dono, mapa->tropas, mapa->tamanho, numDonos, territorios, tropas);
+    }
+}
+
+void reduzirPorDono(const Mapa* mapa, int numDonos, int* territorios, long long* tropas) {
+    ImplementacaoReducao impl = numDonos <= MAX_DONOS_VETORIAL ? implementacaoReducaoAtiva() : REDUCAO_ESCALAR;
+    reduzirPorDonoCom(impl, mapa, numDonos, territorios, tropas);
+}
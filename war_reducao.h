@@ -0,0 +1,29 @@
+/* war_reducao.h
+   Contagem de territórios e soma de tropas de todas as cores numa única
+   passada pelo mapa em colunas. Há versões escalar, SSE2 e AVX2; a melhor
+   suportada pela CPU é escolhida na primeira chamada (e a escalar quando há
+   cores demais). Todas dão exatamente o mesmo resultado (só somas inteiras).
+*/
+
+#ifndef WAR_REDUCAO_H
+#define WAR_REDUCAO_H
+
+#include "war_mapa.h"
+
+typedef enum {
+    REDUCAO_ESCALAR = 0,
+    REDUCAO_SSE2,
+    REDUCAO_AVX2
+} ImplementacaoReducao;
+
+/* Preenche territorios[d] e tropas[d] para d em [0, numDonos).
+   Donos fora desse intervalo são ignorados. */
+void reduzirPorDono(const Mapa* mapa, int numDonos, int* territorios, long long* tropas);
+void reduzirPorDonoCom(ImplementacaoReducao impl, const Mapa* mapa, int numDonos,
+                       int* territorios, long long* tropas);
+
+ImplementacaoReducao implementacaoReducaoAtiva(void);
+int implementacaoReducaoSuportada(ImplementacaoReducao impl);
+const char* nomeImplementacaoReducao(ImplementacaoReducao impl);
+
+#endif
@@ -0,0 +1,118 @@
+/* war_regras.h
+   Regras de combate, escolhidas na compilação (-DWAR_REGRAS=..., ou
+   make REGRAS=1x1|classica|blitz):
+     - REGRAS_1X1 (padrão): um dado de cada lado; com dado maior o atacante
+       conquista o território, senão perde 1 tropa;
+     - REGRAS_CLASSICA: até 3 dados de ataque (um a menos que as tropas)
+       contra até 2 de defesa, comparados em pares do maior para o menor;
+       cada par perdido custa 1 tropa (empate favorece o defensor) e o
+       território cai quando o defensor fica sem tropas;
+     - REGRAS_BLITZ: rodadas clássicas seguidas num único ataque, até
+       conquistar ou o atacante ficar com menos de MIN_TROPAS_ATAQUE tropas.
+
+   Só a regra escolhida é compilada em batalhar(), então a batalha não testa
+   a regra em tempo de execução. As rodadas clássicas não rolam dado por
+   dado: sorteiam um dos 6^(a+d) lances e consultam tabelaRodadasClassicas
+   (war_dados.h) com duas comparações, sem desvio. Para comparar as regras,
+   make regras compila um simulador para cada uma.
+*/
+
+#ifndef WAR_REGRAS_H
+#define WAR_REGRAS_H
+
+#include <stdlib.h>
+
+#include "war_aleatorio.h"
+#include "war_dados.h"
+#include "war_jogo.h"
+
+#define REGRAS_1X1 1
+#define REGRAS_CLASSICA 2
+#define REGRAS_BLITZ 3
+
+#ifndef WAR_REGRAS
+#define WAR_REGRAS REGRAS_1X1
+#endif
+
+#if WAR_REGRAS == REGRAS_1X1
+#define NOME_REGRAS "1x1"
+#elif WAR_REGRAS == REGRAS_CLASSICA
+#define NOME_REGRAS "classica"
+#elif WAR_REGRAS == REGRAS_BLITZ
+#define NOME_REGRAS "blitz"
+#else
+#error "WAR_REGRAS deve ser REGRAS_1X1, REGRAS_CLASSICA ou REGRAS_BLITZ"
+#endif
+
+/* Resultado de um ataque. Na 1x1 os dados são os rolados; nas clássicas são
+   quantos dados cada lado usou na primeira rodada. */
+typedef struct {
+    int conquista;
+    int perdasAtacante;
+    int perdasDefensor;    // só nas clássicas: na 1x1 a conquista não tira tropas do defensor
+    int dadoAtacante, dadoDefensor;
+} ResultadoBatalha;
+
+/* Inteiro uniforme em [0, n): do gerador, ou de rand() descartando o topo da
+   faixa que daria viés a rand() % n. */
+static inline int sortearLance(GeradorAleatorio* g, int n) {
+    if (g) return geradorIntervalo(g, n);
+    int r;
+    do {
+        r = rand();
+    } while (r >= RAND_MAX - RAND_MAX % n);
+    return r % n;
+}
+
+#if WAR_REGRAS != REGRAS_1X1
+/* Uma rodada clássica: os dados de cada lado saem das tropas e o resultado
+   de um único lance sorteado. */
+static inline void rodadaClassica(GeradorAleatorio* g, int tropasAtq, int tropasDef, ResultadoBatalha* r) {
+    int a = tropasAtq - 1 < 1 ? 1 : tropasAtq - 1 > 3 ? 3 : tropasAtq - 1;
+    int d = tropasDef < 1 ? 1 : tropasDef > 2 ? 2 : tropasDef;
+    const RodadaClassica* t = &tabelaRodadasClassicas[a - 1][d - 1];
+    uint32_t lance = (uint32_t) sortearLance(g, (int) t->total);
+    int perdasDef = (lance >= t->limites[0]) + (lance >= t->limites[1]);
+    r->perdasDefensor += perdasDef;
+    r->perdasAtacante += t->comparacoes - perdasDef;
+    if (r->dadoAtacante == 0) {
+        r->dadoAtacante = a;
+        r->dadoDefensor = d;
+    }
+}
+#endif
+
+/* Resolve um ataque válido (atacante com tropas, defensor de outra cor) pela
+   regra compilada. Não altera os territórios: quem chama aplica as perdas e,
+   na conquista, a transferência. */
+static inline ResultadoBatalha batalhar(GeradorAleatorio* g, int tropasAtq, int tropasDef) {
+    ResultadoBatalha r = {0, 0, 0, 0, 0};
+#if WAR_REGRAS == REGRAS_1X1
+    (void) tropasAtq;
+    (void) tropasDef;
+    if (g) {
+        rolarDuplaD6(g, &r.dadoAtacante, &r.dadoDefensor);
+    } else {
+        r.dadoAtacante = sortearLance(NULL, 6) + 1;
+        r.dadoDefensor = sortearLance(NULL, 6) + 1;
+    }
+    r.conquista = r.dadoAtacante > r.dadoDefensor;
+    r.perdasAtacante = !r.conquista;
+#else
+    if (tropasDef <= 0) { // território vazio: cai sem rodada
+        r.conquista = 1;
+        return r;
+    }
+#if WAR_REGRAS == REGRAS_CLASSICA
+    rodadaClassica(g, tropasAtq, tropasDef, &r);
+#else
+    do {
+        rodadaClassica(g, tropasAtq - r.perdasAtacante, tropasDef - r.perdasDefensor, &r);
+    } while (r.perdasDefensor < tropasDef && tropasAtq - r.perdasAtacante >= MIN_TROPAS_ATAQUE);
+#endif
+    r.conquista = r.perdasDefensor >= tropasDef;
+#endif
+    return r;
+}
+
+#endif
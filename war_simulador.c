@@ -0,0 +1,670 @@
+/* war_simulador.c
+   Simulador em lote do nível mestre: joga N partidas completas sem interação,
+   com políticas automáticas para os jogadores, e reporta partidas/segundo e a
+   taxa de vitória por id de missão.
+   Reutiliza as regras de war_jogo.c sem diário de eventos por padrão, então o
+   laço quente não faz printf nem fgets. Com -o cada thread grava os eventos
+   das suas partidas (war_eventos.h) em um buffer descarregado em blocos.
+
+   As partidas são divididas em blocos contíguos entre threads. Cada thread tem
+   seu próprio GeradorAleatorio (a semente mestre saltada 2^128 posições por
+   thread) e suas próprias estatísticas, somadas só depois do pthread_join.
+   A mesma semente com o mesmo número de threads gera sempre o mesmo relatório.
+
+   Uso: war_simulador [-n partidas] [-s semente] [-t maxTurnos] [-c threads]
+                      [-m territorios] [-j jogadores] [-p aleatoria|gulosa] [-v 0|1]
+                      [-i 0|1] [-a cenario] [-e cenario] [-l cenario.csv]
+                      [-o eventos[.jsonl|.txt]] [-d 1|2] [-b assentos] [-k iteracoes]
+                      [-x ordens] [-r threads]
+   Com -i 1 cada ataque escolhido vira uma investida (investirNoEstado): a
+   sequência de batalhas até conquistar ou esgotar as tropas é resolvida com
+   um único sorteio, em vez de uma batalha por turno.
+   Com -e o mapa inicial (e suas fronteiras) é gravado em um jogo salvo, e com
+   -a o mapa inicial é aberto de um jogo salvo em vez de gerado (war_arquivo.c).
+   Com -l o mapa inicial é lido de um cenário em texto (war_csv.h; "-" lê da
+   entrada padrão), com fronteiras em grade; -l e -e juntos convertem o texto
+   para o formato binário.
+   Com -b os primeiros 'assentos' jogadores são o jogador de busca em árvore
+   (war_mcts.h) com -k iterações por jogada; os demais seguem -p. O limite é
+   em iterações, não em tempo, para manter o resultado reproduzível.
+   Com -x os turnos são simultâneos: a cada turno todos os jogadores entregam
+   até 'ordens' ataques escolhidos por -p, resolvidos juntos por war_ordens.h
+   com -r threads por partida (além das -c threads entre partidas). Com -v 1
+   cada lote também é resolvido em sequência numa cópia do estado e os dois
+   resultados são comparados.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "war_arena.h"
+#include "war_arquivo.h"
+#include "war_eventos.h"
+#include "war_jogo.h"
+#include "war_mcts.h"
+#include "war_ordens.h"
+#include "war_reducao.h"
+#include "war_regras.h"
+
+#define MAX_JOGADORES 4
+#define MAX_MISSOES_ID 16
+
+typedef enum {
+    POLITICA_ALEATORIA, // ataca de um território próprio qualquer contra um inimigo qualquer
+    POLITICA_GULOSA     // ataca do território mais forte contra o inimigo mais fraco
+} Politica;
+
+typedef struct {
+    long partidas;
+    unsigned long long semente;
+    int maxTurnos;
+    int numThreads;
+    int numTerritorios;     // 0 = mapa de demonstração do nivel-mestre
+    int numJogadores;
+    Politica politica;
+    int revalidar;          // 1 = recontar o mapa inteiro ao fim de cada partida
+    int investir;           // 1 = cada ataque continua até conquistar ou esgotar as tropas
+    const char* abrirCenario;    // jogo salvo usado como mapa inicial (NULL = gerar)
+    const char* gravarCenario;   // onde gravar o mapa inicial (NULL = não gravar)
+    const char* lerCenario;      // cenário em texto usado como mapa inicial ("-" = entrada padrão)
+    const char* arquivoEventos;  // diário de eventos; com várias threads, um arquivo por thread (.0, .1...)
+    NivelEventos nivelEventos;
+    int assentosMcts;            // os primeiros jogadores que usam a busca em árvore
+    long iteracoesMcts;          // iterações da busca por jogada
+    int ordensPorJogador;        // 0 = um ataque por turno; > 0 = turnos simultâneos
+    int threadsOrdens;           // threads de cada partida que resolvem os lotes de ordens
+} ConfigSimulacao;
+
+typedef struct {
+    long partidas;
+    long empates;
+    long divergencias;      // partidas em que os agregados incrementais não bateram com a recontagem
+    long turnosTotais;
+    long vitoriasPorJogador[MAX_JOGADORES];
+    long missoesAtribuidas[MAX_MISSOES_ID];
+    long missoesVencedoras[MAX_MISSOES_ID];
+    long long iteracoesMcts;
+    double segundosMcts;
+    long long ordensEntregues;
+    long long ordensExecutadas;
+    long lotesDivergentes;  // lotes em que a resolução paralela não bateu com a sequencial
+} EstatisticasSimulacao;
+
+/* Estado privado de cada thread. Alinhado em 64 bytes para que as estatísticas
+   de threads vizinhas não compartilhem linha de cache. */
+typedef struct {
+    _Alignas(64) GeradorAleatorio gerador;
+    EstatisticasSimulacao est;
+    const ConfigSimulacao* cfg;
+    const Mapa* inicial;
+    const GrafoMapa* grafo;
+    long primeiraPartida;
+    long ultimaPartida; // exclusiva
+    int indice;
+    int ok;
+} Trabalhador;
+
+static const char* coresJogadores[MAX_JOGADORES] = {"Azul", "Verde", "Amarelo", "Vermelho"};
+static int donosJogadores[MAX_JOGADORES]; // ids no registro de cores, preenchidos antes das threads
+
+/* ----------------------- Mapa inicial ----------------------- */
+
+/* Monta o mapa inicial. Com numTerritorios == 0 usa o mapa de demonstração;
+   caso contrário gera um mapa com as cores distribuídas em rodízio entre os
+   jogadores e a cor neutra "Vermelho" (alvo da missão 2). O território 0 se
+   chama "Fortaleza" para que a missão 5 seja sempre possível. As fronteiras
+   do mapa gerado formam uma grade (criarGrafoGrade). */
+static int criarMapaInicial(const ConfigSimulacao* cfg, GeradorAleatorio* g, Mapa* mapa) {
+    if (cfg->numTerritorios == 0) {
+        Territorio territorios[NUM_TERRITORIOS_PADRAO];
+        inicializarMapaPadrao(territorios);
+        return criarMapaDeTerritorios(mapa, territorios, NUM_TERRITORIOS_PADRAO, NULL);
+    }
+
+    int n = cfg->numTerritorios;
+    if (!criarMapa(mapa, n, (size_t) n * 12)) return 0; // "T" + até 10 dígitos + '\0'
+    int numCores = cfg->numJogadores < MAX_JOGADORES ? cfg->numJogadores + 1 : MAX_JOGADORES;
+    int vermelho = registrarCor("Vermelho");
+    char nome[MAX_NOME];
+    for (int i = 0; i < n; ++i) {
+        if (i == 0) strcpy(nome, "Fortaleza");
+        else snprintf(nome, sizeof(nome), "T%d", i);
+        definirNomeTerritorio(mapa, i, nome);
+        mapa->dono[i] = (i % numCores) < cfg->numJogadores ? donosJogadores[i % numCores] : vermelho;
+        mapa->tropas[i] = 1 + geradorIntervalo(g, 5);
+    }
+    return 1;
+}
+
+/* Lê o mapa inicial de um cenário em texto, mostrando o erro com a linha. */
+static int lerMapaCsv(const char* caminho, Mapa* mapa) {
+    int entradaPadrao = strcmp(caminho, "-") == 0;
+    FILE* f = entradaPadrao ? stdin : fopen(caminho, "r");
+    if (!f) {
+        perror(caminho);
+        return 0;
+    }
+    ErroImportacao erro;
+    int ok = importarMapaCsv(f, mapa, &erro);
+    if (!entradaPadrao) fclose(f);
+    if (!ok && erro.linha > 0) fprintf(stderr, "%s:%d: %s\n", caminho, erro.linha, erro.mensagem);
+    else if (!ok) fprintf(stderr, "%s: %s\n", caminho, erro.mensagem);
+    return ok;
+}
+
+/* ----------------------- Políticas ----------------------- */
+
+/* Escolhe um ataque para o jogador de cor 'dono' entre os ataques legais
+   (fronteira, cor inimiga e pelo menos MIN_TROPAS_ATAQUE tropas no atacante),
+   o que garante que as tropas totais nunca crescem e a partida sempre termina.
+   'ataques' é um vetor de trabalho com capacidade para todas as fronteiras.
+   Retorna 0 se o jogador deve passar o turno. */
+static int escolherAtaque(Politica politica, const EstadoJogo* estado, int dono,
+                          Ataque* ataques, int capacidade, int* idxAtq, int* idxDef) {
+    int total = gerarAtaquesLegais(estado, dono, ataques, capacidade);
+    if (total == 0) return 0;
+
+    int escolhido = 0;
+    if (politica == POLITICA_GULOSA) {
+        // maior vantagem de tropas entre atacante e defensor
+        const int* tropas = estado->mapa->tropas;
+        int melhor = tropas[ataques[0].atacante] - tropas[ataques[0].defensor];
+        for (int k = 1; k < total; ++k) {
+            int vantagem = tropas[ataques[k].atacante] - tropas[ataques[k].defensor];
+            if (vantagem > melhor) { melhor = vantagem; escolhido = k; }
+        }
+    } else {
+        escolhido = geradorIntervalo(estado->gerador, total);
+    }
+    *idxAtq = ataques[escolhido].atacante;
+    *idxDef = ataques[escolhido].defensor;
+    return 1;
+}
+
+/* Lote de um turno simultâneo: leva para o início de 'ataques' até 'limite'
+   dos 'total' ataques legais, sorteados sem repetição ou, na gulosa, os de
+   maior vantagem de tropas. Retorna quantos escolheu. */
+static int escolherOrdens(Politica politica, const EstadoJogo* estado, Ataque* ataques, int total, int limite) {
+    int escolhidos = total < limite ? total : limite;
+    const int* tropas = estado->mapa->tropas;
+    for (int k = 0; k < escolhidos; ++k) {
+        int escolhido = k;
+        if (politica == POLITICA_GULOSA) {
+            int melhor = tropas[ataques[k].atacante] - tropas[ataques[k].defensor];
+            for (int q = k + 1; q < total; ++q) {
+                int vantagem = tropas[ataques[q].atacante] - tropas[ataques[q].defensor];
+                if (vantagem > melhor) { melhor = vantagem; escolhido = q; }
+            }
+        } else {
+            escolhido = k + geradorIntervalo(estado->gerador, total - k);
+        }
+        Ataque troca = ataques[k];
+        ataques[k] = ataques[escolhido];
+        ataques[escolhido] = troca;
+    }
+    return escolhidos;
+}
+
+/* ----------------------- Partida ----------------------- */
+
+/* Joga uma partida completa sobre o estado (mapa e agregados já inicializados).
+   Retorna o índice do jogador vencedor ou -1 em caso de empate
+   (ninguém consegue mais atacar ou o limite de turnos foi atingido). */
+static int jogarPartida(const ConfigSimulacao* cfg, EstadoJogo* estado, const Missao* missoesJogadores,
+                        Ataque* ataques, int capacidade, JogadorMcts* mcts, EstatisticasSimulacao* est,
+                        int* turnosJogados) {
+    int numJogadores = cfg->numJogadores;
+    int passesSeguidos = 0;
+    int turno = 0;
+    int vencedor = -1;
+
+    for (; turno < cfg->maxTurnos; ++turno) {
+        int jogadorAtual = turno % numJogadores;
+        if (diarioAtivo) diarioAtivo->turno = turno;
+        int idxAtq, idxDef, escolheu;
+        if (jogadorAtual < cfg->assentosMcts) {
+            escolheu = escolherJogadaMcts(mcts, estado, missoesJogadores, donosJogadores, numJogadores, jogadorAtual,
+                                          &idxAtq, &idxDef);
+            est->iteracoesMcts += mcts->iteracoes;
+            est->segundosMcts += mcts->segundos;
+        } else {
+            escolheu = escolherAtaque(cfg->politica, estado, donosJogadores[jogadorAtual], ataques, capacidade,
+                                      &idxAtq, &idxDef);
+        }
+        if (escolheu) {
+            if (cfg->investir) investirNoEstado(estado, idxAtq, idxDef);
+            else atacarNoEstado(estado, idxAtq, idxDef);
+            passesSeguidos = 0;
+        } else {
+            passesSeguidos++;
+        }
+
+        // mesma ordem de verificação do laço de turnos do nivel-mestre
+        for (int j = 0; j < numJogadores; ++j) {
+            if (verificarMissaoNoEstado(&missoesJogadores[j], estado, donosJogadores[j])) {
+                if (eventosAtivos(NIVEL_EVENTOS_PARTIDA)) {
+                    Evento e = {EVENTO_MISSAO_CUMPRIDA, -1, -1, NULL, NULL, donosJogadores[j], -1, 0, 0, 0, 0,
+                                missoesJogadores[j].id};
+                    emitirEvento(&e);
+                }
+                vencedor = j;
+                break;
+            }
+        }
+        if (vencedor != -1 || passesSeguidos >= numJogadores) {
+            turno++;
+            break;
+        }
+    }
+    *turnosJogados = turno;
+    return vencedor;
+}
+
+/* Partida em turnos simultâneos: a cada turno todos os jogadores entregam um
+   lote de ordens, resolvidas juntas (war_ordens.h) a partir do jogador
+   'turno % numJogadores'. Termina em empate quando ninguém tem o que atacar.
+   Com 'referencia', cada lote também é resolvido em sequência sobre uma
+   cópia do estado, e os lotes em que mapa ou agregados diferem são contados. */
+static int jogarPartidaSimultanea(const ConfigSimulacao* cfg, EstadoJogo* estado, const Missao* missoesJogadores,
+                                  Ataque* ataques, int capacidade, ResolvedorOrdens* resolvedor,
+                                  EstadoJogo* referencia, EstatisticasSimulacao* est, int* turnosJogados) {
+    int numJogadores = cfg->numJogadores;
+    int turno = 0;
+    int vencedor = -1;
+    size_t bytesMapa = sizeof(int) * estado->mapa->tamanho;
+
+    for (; turno < cfg->maxTurnos; ++turno) {
+        if (diarioAtivo) diarioAtivo->turno = turno;
+        iniciarLoteOrdens(resolvedor, numJogadores, turno % numJogadores, geradorProximo(estado->gerador));
+        int entregues = 0;
+        for (int j = 0; j < numJogadores; ++j) {
+            int total = gerarAtaquesLegais(estado, donosJogadores[j], ataques, capacidade);
+            int escolhidos = escolherOrdens(cfg->politica, estado, ataques, total, cfg->ordensPorJogador);
+            entregues += entregarOrdens(resolvedor, j, donosJogadores[j], ataques, escolhidos);
+        }
+        if (entregues == 0) {
+            turno++;
+            break;
+        }
+        est->ordensEntregues += entregues;
+
+        if (referencia) {
+            restaurarMapa(referencia->mapa, estado->mapa);
+            referencia->agregados = estado->agregados;
+        }
+        est->ordensExecutadas += resolverOrdens(resolvedor, estado);
+        if (referencia) {
+            resolverOrdensEmSequencia(resolvedor, referencia);
+            if (memcmp(referencia->mapa->dono, estado->mapa->dono, bytesMapa) != 0 ||
+                memcmp(referencia->mapa->tropas, estado->mapa->tropas, bytesMapa) != 0 ||
+                memcmp(&referencia->agregados, &estado->agregados, sizeof(AgregadosJogo)) != 0)
+                est->lotesDivergentes++;
+        }
+
+        for (int j = 0; j < numJogadores; ++j) {
+            if (verificarMissaoNoEstado(&missoesJogadores[j], estado, donosJogadores[j])) {
+                if (eventosAtivos(NIVEL_EVENTOS_PARTIDA)) {
+                    Evento e = {EVENTO_MISSAO_CUMPRIDA, -1, -1, NULL, NULL, donosJogadores[j], -1, 0, 0, 0, 0,
+                                missoesJogadores[j].id};
+                    emitirEvento(&e);
+                }
+                vencedor = j;
+                break;
+            }
+        }
+        if (vencedor != -1) {
+            turno++;
+            break;
+        }
+    }
+    *turnosJogados = turno;
+    return vencedor;
+}
+
+/* Abre o diário de eventos da thread, se pedido com -o, reservado na arena da thread. */
+static DiarioEventos* abrirDiarioTrabalhador(const Trabalhador* t, ArenaJogo* arena, FILE** arquivo) {
+    const ConfigSimulacao* cfg = t->cfg;
+    *arquivo = NULL;
+    if (!cfg->arquivoEventos) return NULL;
+    char caminho[512];
+    if (cfg->numThreads > 1) snprintf(caminho, sizeof(caminho), "%s.%d", cfg->arquivoEventos, t->indice);
+    else snprintf(caminho, sizeof(caminho), "%s", cfg->arquivoEventos);
+    DiarioEventos* diario = (DiarioEventos*) reservarNaArena(arena, sizeof(DiarioEventos));
+    *arquivo = diario ? fopen(caminho, "wb") : NULL;
+    if (!*arquivo) {
+        perror(caminho);
+        return NULL;
+    }
+    abrirDiarioEventos(diario, *arquivo, formatoEventosPorNome(cfg->arquivoEventos), cfg->nivelEventos);
+    usarDiarioEventos(diario);
+    return diario;
+}
+
+/* Joga as partidas [primeiraPartida, ultimaPartida) de um trabalhador.
+   Só toca em memória própria; nenhuma trava é necessária. O mapa, o
+   catálogo, os ataques e o diário da thread saem de uma arena reservada uma
+   vez: cada partida só copia o mapa inicial por cima, sem alocar nada. */
+static void* executarTrabalhador(void* arg) {
+    Trabalhador* t = (Trabalhador*) arg;
+    const ConfigSimulacao* cfg = t->cfg;
+    EstatisticasSimulacao* est = &t->est;
+    int tamanho = t->inicial->tamanho;
+    int capacidade = t->grafo->inicio[tamanho] > 0 ? t->grafo->inicio[tamanho] : 1;
+
+    ArenaJogo arena;
+    int conferirOrdens = cfg->ordensPorJogador > 0 && cfg->revalidar;
+    size_t bytesMapa = bytesNaArena(sizeof(int) * 2 * (tamanho > 0 ? tamanho : 1));
+    size_t bytesArena = bytesMapa * (conferirOrdens ? 2 : 1) +
+                        bytesNaArena(sizeof(Missao) * totalMissoesDisponiveis) +
+                        bytesNaArena(sizeof(Ataque) * capacidade) +
+                        (cfg->arquivoEventos ? bytesNaArena(sizeof(DiarioEventos)) : 0);
+    if (!criarArena(&arena, bytesArena)) return NULL;
+    Mapa mapa, mapaReferencia; // dono e tropas próprios, nomes compartilhados com o mapa inicial
+    copiarMapaNaArena(&mapa, t->inicial, &arena);
+    if (conferirOrdens) copiarMapaNaArena(&mapaReferencia, t->inicial, &arena);
+    Missao* catalogo = (Missao*) reservarNaArena(&arena, sizeof(Missao) * totalMissoesDisponiveis);
+    Ataque* ataques = (Ataque*) reservarNaArena(&arena, sizeof(Ataque) * capacidade);
+    FILE* arquivoEventos;
+    DiarioEventos* diario = abrirDiarioTrabalhador(t, &arena, &arquivoEventos);
+    if (cfg->arquivoEventos && !diario) {
+        liberarArena(&arena);
+        return NULL;
+    }
+
+    // o catálogo é compilado uma vez (registrando os alvos) e os agregados do
+    // mapa inicial são calculados uma vez; cada partida só os copia
+    EstadoJogo estado;
+    iniciarEstadoJogo(&estado, &mapa, t->grafo, &t->gerador);
+    for (int i = 0; i < totalMissoesDisponiveis; ++i) compilarMissao(&catalogo[i], missoesDisponiveis[i], &estado);
+    AgregadosJogo agregadosIniciais = estado.agregados;
+    EstadoJogo referencia = estado;
+    referencia.mapa = &mapaReferencia;
+    ResolvedorOrdens resolvedor;
+    int resolvedorOk = 0;
+    if (cfg->ordensPorJogador > 0) {
+        long ordensPorLote = (long) cfg->ordensPorJogador * cfg->numJogadores;
+        resolvedorOk = criarResolvedorOrdens(&resolvedor, tamanho, ordensPorLote < capacidade ? (int) ordensPorLote
+                                                                                             : capacidade,
+                                             cfg->threadsOrdens);
+        if (!resolvedorOk) {
+            if (diario) {
+                fecharDiarioEventos(diario);
+                fclose(arquivoEventos);
+            }
+            liberarArena(&arena);
+            return NULL;
+        }
+    }
+    JogadorMcts mcts;
+    int mctsOk = 0;
+    if (cfg->assentosMcts > 0) {
+        ConfigMcts cfgMcts = configMctsPadrao();
+        cfgMcts.segundosPorJogada = 0.0;
+        cfgMcts.maxIteracoes = cfg->iteracoesMcts;
+        mctsOk = criarJogadorMcts(&mcts, &cfgMcts, &estado, geradorProximo(&t->gerador));
+        if (!mctsOk) {
+            if (resolvedorOk) liberarResolvedorOrdens(&resolvedor);
+            if (diario) {
+                fecharDiarioEventos(diario);
+                fclose(arquivoEventos);
+            }
+            liberarArena(&arena);
+            return NULL;
+        }
+    }
+
+    Missao missoesJogadores[MAX_JOGADORES];
+    for (long p = t->primeiraPartida; p < t->ultimaPartida; ++p) {
+        restaurarMapa(&mapa, t->inicial);
+        estado.agregados = agregadosIniciais;
+        if (diario) diario->partida = p;
+        for (int j = 0; j < cfg->numJogadores; ++j) {
+            missoesJogadores[j] = catalogo[geradorIntervalo(&t->gerador, totalMissoesDisponiveis)];
+            int id = missoesJogadores[j].id;
+            if (id > 0 && id < MAX_MISSOES_ID) est->missoesAtribuidas[id]++;
+        }
+
+        int turnos = 0;
+        int vencedor = resolvedorOk ? jogarPartidaSimultanea(cfg, &estado, missoesJogadores, ataques, capacidade,
+                                                             &resolvedor, conferirOrdens ? &referencia : NULL,
+                                                             est, &turnos)
+                                    : jogarPartida(cfg, &estado, missoesJogadores, ataques, capacidade, &mcts, est,
+                                                   &turnos);
+        est->partidas++;
+        est->turnosTotais += turnos;
+        if (cfg->revalidar && !validarAgregados(&estado)) est->divergencias++;
+        if (vencedor < 0) {
+            est->empates++;
+        } else {
+            est->vitoriasPorJogador[vencedor]++;
+            int id = missoesJogadores[vencedor].id;
+            if (id > 0 && id < MAX_MISSOES_ID) est->missoesVencedoras[id]++;
+        }
+    }
+
+    if (mctsOk) liberarJogadorMcts(&mcts);
+    if (resolvedorOk) liberarResolvedorOrdens(&resolvedor);
+    t->ok = 1;
+    if (diario) {
+        fecharDiarioEventos(diario);
+        t->ok = fclose(arquivoEventos) == 0;
+    }
+    liberarArena(&arena);
+    return NULL;
+}
+
+static void somarEstatisticas(EstatisticasSimulacao* total, const EstatisticasSimulacao* parcial) {
+    total->partidas += parcial->partidas;
+    total->empates += parcial->empates;
+    total->divergencias += parcial->divergencias;
+    total->turnosTotais += parcial->turnosTotais;
+    for (int j = 0; j < MAX_JOGADORES; ++j) total->vitoriasPorJogador[j] += parcial->vitoriasPorJogador[j];
+    for (int i = 0; i < MAX_MISSOES_ID; ++i) {
+        total->missoesAtribuidas[i] += parcial->missoesAtribuidas[i];
+        total->missoesVencedoras[i] += parcial->missoesVencedoras[i];
+    }
+    total->iteracoesMcts += parcial->iteracoesMcts;
+    total->segundosMcts += parcial->segundosMcts;
+    total->ordensEntregues += parcial->ordensEntregues;
+    total->ordensExecutadas += parcial->ordensExecutadas;
+    total->lotesDivergentes += parcial->lotesDivergentes;
+}
+
+static int simular(const ConfigSimulacao* cfg, EstatisticasSimulacao* est) {
+    GeradorAleatorio mestre;
+    geradorIniciar(&mestre, cfg->semente);
+    for (int j = 0; j < cfg->numJogadores; ++j) donosJogadores[j] = registrarCor(coresJogadores[j]);
+
+    Mapa inicial;    // somente leitura, compartilhado pelas threads
+    GrafoMapa grafo; // idem
+    JogoSalvo cenario;
+    int cenarioOk = 0, mapaOk;
+    if (cfg->abrirCenario) {
+        cenarioOk = abrirJogoSalvo(&cenario, cfg->abrirCenario);
+        if (!cenarioOk) fprintf(stderr, "Não foi possível abrir o cenário %s.\n", cfg->abrirCenario);
+        else inicial = cenario.mapa;
+        mapaOk = cenarioOk;
+    } else if (cfg->lerCenario) {
+        mapaOk = lerMapaCsv(cfg->lerCenario, &inicial);
+    } else {
+        // o mapa usa uma cópia do gerador mestre, então os fluxos das threads
+        // são os mesmos com o mapa gerado ou aberto de um cenário gravado
+        GeradorAleatorio geradorMapa = mestre;
+        mapaOk = criarMapaInicial(cfg, &geradorMapa, &inicial);
+    }
+    // as fronteiras de um cenário pertencem ao arquivo mapeado; sem elas, usa a grade
+    int grafoProprio = 0;
+    if (cenarioOk && cenario.temGrafo) grafo = cenario.grafo;
+    else if (mapaOk && cfg->numTerritorios == 0 && !cfg->abrirCenario && !cfg->lerCenario)
+        grafoProprio = criarGrafoPadrao(&grafo);
+    else if (mapaOk) grafoProprio = criarGrafoGrade(&grafo, inicial.tamanho);
+    int grafoOk = grafoProprio || (cenarioOk && cenario.temGrafo);
+    if (grafoOk && cfg->gravarCenario && !salvarJogo(cfg->gravarCenario, &inicial, &grafo, NULL, 0, 0)) {
+        fprintf(stderr, "Não foi possível gravar o cenário %s.\n", cfg->gravarCenario);
+        grafoOk = 0;
+    }
+    Trabalhador* trabalhadores = (Trabalhador*) aligned_alloc(64, sizeof(Trabalhador) * cfg->numThreads);
+    pthread_t* threads = (pthread_t*) malloc(sizeof(pthread_t) * cfg->numThreads);
+    if (!mapaOk || !grafoOk || !trabalhadores || !threads) {
+        free(trabalhadores); free(threads);
+        if (grafoProprio) liberarGrafo(&grafo);
+        if (cenarioOk) fecharJogoSalvo(&cenario);
+        else if (mapaOk) liberarMapa(&inicial);
+        return 0;
+    }
+
+    long porThread = cfg->partidas / cfg->numThreads;
+    long resto = cfg->partidas % cfg->numThreads;
+    long proxima = 0;
+    int criadas = 0;
+    for (int i = 0; i < cfg->numThreads; ++i) {
+        Trabalhador* t = &trabalhadores[i];
+        memset(t, 0, sizeof(*t));
+        geradorSaltar(&mestre); // fluxo i: semente mestre saltada (i + 1) vezes
+        t->gerador = mestre;
+        t->cfg = cfg;
+        t->inicial = &inicial;
+        t->grafo = &grafo;
+        t->indice = i;
+        t->primeiraPartida = proxima;
+        proxima += porThread + (i < resto ? 1 : 0);
+        t->ultimaPartida = proxima;
+    }
+    for (; criadas < cfg->numThreads; ++criadas) {
+        if (pthread_create(&threads[criadas], NULL, executarTrabalhador, &trabalhadores[criadas]) != 0) break;
+    }
+
+    int ok = (criadas == cfg->numThreads);
+    for (int i = 0; i < criadas; ++i) {
+        pthread_join(threads[i], NULL);
+        ok = ok && trabalhadores[i].ok;
+        somarEstatisticas(est, &trabalhadores[i].est);
+    }
+
+    if (grafoProprio) liberarGrafo(&grafo);
+    if (cenarioOk) fecharJogoSalvo(&cenario);
+    else liberarMapa(&inicial);
+    free(trabalhadores);
+    free(threads);
+    return ok;
+}
+
+/* ----------------------- Relatório ----------------------- */
+
+static void exibirRelatorio(const ConfigSimulacao* cfg, const EstatisticasSimulacao* est, double segundos) {
+    printf("=== Simulação em lote (regras %s) ===\n", NOME_REGRAS);
+    printf("Partidas: %ld | Empates: %ld | Turnos médios: %.2f\n", est->partidas, est->empates,
+           est->partidas ? (double) est->turnosTotais / est->partidas : 0.0);
+    printf("Tempo: %.3f s | %.0f partidas/s\n", segundos, segundos > 0 ? est->partidas / segundos : 0.0);
+    if (cfg->revalidar) {
+        printf("Revalidação (%s): %ld partidas com agregados divergentes\n",
+               nomeImplementacaoReducao(implementacaoReducaoAtiva()), est->divergencias);
+    }
+    if (cfg->ordensPorJogador > 0) {
+        printf("Turnos simultâneos: %lld ordens entregues | %lld executadas | %d thread(s) por partida\n",
+               est->ordensEntregues, est->ordensExecutadas, cfg->threadsOrdens);
+        if (cfg->revalidar)
+            printf("Resolução sequencial de referência: %ld lotes divergentes\n", est->lotesDivergentes);
+    }
+    if (cfg->assentosMcts > 0) {
+        printf("Busca em árvore: %lld iterações | %.0f iterações/s por thread\n", est->iteracoesMcts,
+               est->segundosMcts > 0 ? est->iteracoesMcts / est->segundosMcts : 0.0);
+    }
+
+    printf("\nVitórias por jogador:\n");
+    for (int j = 0; j < cfg->numJogadores; ++j) {
+        printf("  Jogador %d (%-8s): %ld (%.2f%%)\n", j + 1, coresJogadores[j], est->vitoriasPorJogador[j],
+               est->partidas ? 100.0 * est->vitoriasPorJogador[j] / est->partidas : 0.0);
+    }
+
+    printf("\nTaxa de vitória por missão (vitórias / vezes atribuída):\n");
+    for (int i = 0; i < totalMissoesDisponiveis; ++i) {
+        int id = idDaMissao(missoesDisponiveis[i]);
+        if (id <= 0 || id >= MAX_MISSOES_ID) continue;
+        long atribuidas = est->missoesAtribuidas[id];
+        printf("  Missão %d: %8ld / %8ld (%.2f%%)  %s\n", id, est->missoesVencedoras[id], atribuidas,
+               atribuidas ? 100.0 * est->missoesVencedoras[id] / atribuidas : 0.0,
+               strchr(missoesDisponiveis[i], '|') + 1);
+    }
+}
+
+/* ----------------------- Função main ----------------------- */
+
+static void exibirUso(const char* prog) {
+    fprintf(stderr, "Uso: %s [-n partidas] [-s semente] [-t maxTurnos] [-c threads] [-m territorios] "
+                    "[-j jogadores (2-%d)] [-p aleatoria|gulosa] [-v 0|1] [-i 0|1] [-a cenario] [-e cenario] [-l cenario.csv] [-o eventos] [-d 1|2] "
+                    "[-b assentos] [-k iteracoes] [-x ordens] [-r threads]\n", prog, MAX_JOGADORES);
+}
+
+int main(int argc, char** argv) {
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    ConfigSimulacao cfg = {100000, (unsigned long long) time(NULL), 1000, nucleos > 0 ? (int) nucleos : 1,
+                           0, 2, POLITICA_ALEATORIA, 0, 0, NULL, NULL, NULL, NULL, NIVEL_EVENTOS_BATALHA, 0, 1000, 0, 1};
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) { exibirUso(argv[0]); return 1; }
+        const char* valor = argv[++i];
+        if (strcmp(argv[i - 1], "-n") == 0) cfg.partidas = atol(valor);
+        else if (strcmp(argv[i - 1], "-s") == 0) cfg.semente = strtoull(valor, NULL, 10);
+        else if (strcmp(argv[i - 1], "-t") == 0) cfg.maxTurnos = atoi(valor);
+        else if (strcmp(argv[i - 1], "-c") == 0) cfg.numThreads = atoi(valor);
+        else if (strcmp(argv[i - 1], "-m") == 0) cfg.numTerritorios = atoi(valor);
+        else if (strcmp(argv[i - 1], "-j") == 0) cfg.numJogadores = atoi(valor);
+        else if (strcmp(argv[i - 1], "-v") == 0) cfg.revalidar = atoi(valor) != 0;
+        else if (strcmp(argv[i - 1], "-i") == 0) cfg.investir = atoi(valor) != 0;
+        else if (strcmp(argv[i - 1], "-a") == 0) cfg.abrirCenario = valor;
+        else if (strcmp(argv[i - 1], "-e") == 0) cfg.gravarCenario = valor;
+        else if (strcmp(argv[i - 1], "-l") == 0) cfg.lerCenario = valor;
+        else if (strcmp(argv[i - 1], "-o") == 0) cfg.arquivoEventos = valor;
+        else if (strcmp(argv[i - 1], "-d") == 0) cfg.nivelEventos = (NivelEventos) atoi(valor);
+        else if (strcmp(argv[i - 1], "-b") == 0) cfg.assentosMcts = atoi(valor);
+        else if (strcmp(argv[i - 1], "-k") == 0) cfg.iteracoesMcts = atol(valor);
+        else if (strcmp(argv[i - 1], "-x") == 0) cfg.ordensPorJogador = atoi(valor);
+        else if (strcmp(argv[i - 1], "-r") == 0) cfg.threadsOrdens = atoi(valor);
+        else if (strcmp(argv[i - 1], "-p") == 0) {
+            if (strcmp(valor, "aleatoria") == 0) cfg.politica = POLITICA_ALEATORIA;
+            else if (strcmp(valor, "gulosa") == 0) cfg.politica = POLITICA_GULOSA;
+            else { exibirUso(argv[0]); return 1; }
+        } else { exibirUso(argv[0]); return 1; }
+    }
+    if (cfg.partidas < 1 || cfg.maxTurnos < 1 || cfg.numThreads < 1 || cfg.numTerritorios < 0 ||
+        cfg.numJogadores < 2 || cfg.numJogadores > MAX_JOGADORES ||
+        cfg.nivelEventos < NIVEL_EVENTOS_PARTIDA || cfg.nivelEventos > NIVEL_EVENTOS_BATALHA ||
+        cfg.assentosMcts < 0 || cfg.assentosMcts > cfg.numJogadores || cfg.iteracoesMcts < 1 ||
+        cfg.ordensPorJogador < 0 || cfg.threadsOrdens < 1 ||
+        (cfg.numTerritorios > 0 && cfg.numTerritorios < 2)) {
+        exibirUso(argv[0]);
+        return 1;
+    }
+    // o mapa de demonstração só tem territórios de Azul e Verde entre as cores de jogador
+    if (cfg.numTerritorios == 0 && !cfg.abrirCenario && !cfg.lerCenario && cfg.numJogadores > 2) {
+        fprintf(stderr, "Com mais de 2 jogadores informe o tamanho do mapa com -m.\n");
+        return 1;
+    }
+    if (cfg.ordensPorJogador > 0 && (cfg.assentosMcts > 0 || cfg.investir)) {
+        fprintf(stderr, "Os turnos simultâneos (-x) não combinam com -b nem com -i.\n");
+        return 1;
+    }
+
+    EstatisticasSimulacao est;
+    memset(&est, 0, sizeof(est));
+
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    if (!simular(&cfg, &est)) {
+        fprintf(stderr, "Erro: falha ao preparar a simulação.\n");
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+
+    printf("Semente: %llu | Threads: %d\n", cfg.semente, cfg.numThreads);
+    exibirRelatorio(&cfg, &est, segundos);
+    return 0;
+}
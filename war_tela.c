@@ -0,0 +1,163 @@
+/* war_tela.c
+   Quadros do mapa: completos ao trocar de página, só as diferenças depois.
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "war_jogo.h"
+#include "war_tela.h"
+
+#define TAMANHO_LINHA_TELA 128 // linha da tabela, cortada se o nome for maior
+#define TAMANHO_CONTROLE_TELA 16 // posicionamento do cursor e limpeza da linha
+#define TAMANHO_CABECALHO_TELA 256
+#define PRIMEIRA_LINHA_TABELA 4 // título, cabeçalho e separador vêm antes
+#define LINHAS_RESERVADAS_TELA 12 // região de rolagem abaixo do mapa: cabeçalho, prompt e mensagens do turno
+
+static const char cabecalhoTabela[] = "Idx | Nome                 | Cor       | Tropas\n"
+                                      "----+----------------------+-----------+-------\n";
+
+/* ANSI só num terminal que o entende (TERM=dumb não entende). */
+int telaSuportaAnsi(FILE* destino) {
+    const char* termo = getenv("TERM");
+    return isatty(fileno(destino)) && termo && strcmp(termo, "dumb") != 0;
+}
+
+/* Linhas da página que cabem no terminal junto com o prompt e as mensagens
+   do turno; se a rolagem empurrar o mapa para cima, as linhas reescritas
+   no lugar cairiam nas posições erradas. */
+int linhasPorPaginaDoTerminal(FILE* destino) {
+    struct winsize janela;
+    if (ioctl(fileno(destino), TIOCGWINSZ, &janela) != 0 || janela.ws_row == 0) return LINHAS_POR_PAGINA_PADRAO;
+    int linhas = janela.ws_row - LINHAS_RESERVADAS_TELA;
+    return linhas > 4 ? linhas : 4;
+}
+
+int criarTelaMapa(TelaMapa* tela, const Mapa* mapa, FILE* destino, int linhasPorPagina, int ansi) {
+    memset(tela, 0, sizeof(*tela));
+    tela->mapa = mapa;
+    tela->destino = destino;
+    tela->ansi = ansi;
+    tela->linhasPorPagina = linhasPorPagina > 0 ? linhasPorPagina : LINHAS_POR_PAGINA_PADRAO;
+    tela->paginaDesenhada = -1;
+    tela->capacidade = TAMANHO_CABECALHO_TELA + sizeof(cabecalhoTabela) +
+                       (size_t) tela->linhasPorPagina * (TAMANHO_LINHA_TELA + TAMANHO_CONTROLE_TELA);
+    tela->donoDesenhado = (int*) malloc(sizeof(int) * tela->linhasPorPagina);
+    tela->tropasDesenhadas = (int*) malloc(sizeof(int) * tela->linhasPorPagina);
+    tela->texto = (char*) malloc(tela->capacidade);
+    if (!tela->donoDesenhado || !tela->tropasDesenhadas || !tela->texto) {
+        liberarTelaMapa(tela);
+        return 0;
+    }
+    return 1;
+}
+
+void liberarTelaMapa(TelaMapa* tela) {
+    if (tela->rolagem) {
+        // devolve o terminal inteiro à rolagem (o que move o cursor) e volta o cursor ao prompt
+        fputs("\0337\033[r\0338", tela->destino);
+        fflush(tela->destino);
+        tela->rolagem = 0;
+    }
+    free(tela->donoDesenhado);
+    free(tela->tropasDesenhadas);
+    free(tela->texto);
+    tela->donoDesenhado = tela->tropasDesenhadas = NULL;
+    tela->texto = NULL;
+}
+
+int paginasDaTela(const TelaMapa* tela) {
+    int paginas = (tela->mapa->tamanho + tela->linhasPorPagina - 1) / tela->linhasPorPagina;
+    return paginas > 0 ? paginas : 1;
+}
+
+/* Páginas fora do intervalo dão a volta (a seguinte à última é a primeira). */
+void mudarPaginaTela(TelaMapa* tela, int pagina) {
+    int paginas = paginasDaTela(tela);
+    tela->pagina = ((pagina % paginas) + paginas) % paginas;
+}
+
+/* O próximo quadro será completo (por exemplo, depois de a tela ser rolada). */
+void invalidarTela(TelaMapa* tela) {
+    tela->paginaDesenhada = -1;
+}
+
+/* Acrescenta ao quadro, cortando no que couber; com o buffer cheio (só
+   resta o lugar do '\0') não escreve nada. */
+static void acrescentarTela(TelaMapa* tela, const char* formato, ...) {
+    size_t livre = tela->capacidade - tela->usados;
+    if (livre <= 1) return;
+    size_t limite = livre < TAMANHO_LINHA_TELA ? livre : TAMANHO_LINHA_TELA;
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(tela->texto + tela->usados, limite, formato, args);
+    va_end(args);
+    if (n > 0) tela->usados += (size_t) n < limite ? (size_t) n : limite - 1;
+}
+
+static void linhaTela(TelaMapa* tela, int i) {
+    const Mapa* m = tela->mapa;
+    acrescentarTela(tela, "%3d | %-20s | %-9s | %5d", i, nomeDoTerritorio(m, i), nomeDaCor(m->dono[i]),
+                    m->tropas[i]);
+}
+
+/* Desenha a página atual: completa se ela ainda não está na tela, senão só
+   as linhas cujo dono ou tropas mudaram. Com ANSI o quadro parcial guarda e
+   devolve a posição do cursor, então o que já foi escrito na região de
+   mensagens continua lá. Retorna quantas linhas escreveu. */
+int desenharTela(TelaMapa* tela) {
+    const Mapa* m = tela->mapa;
+    int primeiro = tela->pagina * tela->linhasPorPagina;
+    int linhas = m->tamanho - primeiro < tela->linhasPorPagina ? m->tamanho - primeiro : tela->linhasPorPagina;
+    int completo = tela->paginaDesenhada != tela->pagina;
+    int escritas = 0;
+    tela->usados = 0;
+
+    if (completo) {
+        if (tela->ansi) acrescentarTela(tela, "\033[r\033[H\033[2J");
+        else acrescentarTela(tela, "\n");
+        acrescentarTela(tela, "Mapa atual (página %d de %d, territórios %d a %d):\n", tela->pagina + 1,
+                        paginasDaTela(tela), primeiro, primeiro + linhas - 1);
+        acrescentarTela(tela, "%s", cabecalhoTabela);
+    }
+    for (int r = 0; r < linhas; ++r) {
+        int i = primeiro + r;
+        if (!completo && tela->donoDesenhado[r] == m->dono[i] && tela->tropasDesenhadas[r] == m->tropas[i])
+            continue;
+        if (!completo && tela->ansi) {
+            acrescentarTela(tela, escritas == 0 ? "\0337\033[%d;1H" : "\033[%d;1H", PRIMEIRA_LINHA_TABELA + r);
+        } else if (!completo && escritas == 0) {
+            acrescentarTela(tela, "\nTerritórios alterados:\n");
+            acrescentarTela(tela, "%s", cabecalhoTabela);
+        }
+        linhaTela(tela, i);
+        acrescentarTela(tela, !tela->ansi ? "\n" : completo ? "\033[K\n" : "\033[K");
+        tela->donoDesenhado[r] = m->dono[i];
+        tela->tropasDesenhadas[r] = m->tropas[i];
+        escritas++;
+    }
+    if (tela->ansi && completo) {
+        // da linha após o separador até o fim da tela rolam as mensagens e o prompt
+        acrescentarTela(tela, "\033[%d;r\033[%d;1H", PRIMEIRA_LINHA_TABELA + linhas + 1,
+                        PRIMEIRA_LINHA_TABELA + linhas + 1);
+        tela->rolagem = 1;
+    } else if (tela->ansi) {
+        if (escritas > 0) acrescentarTela(tela, "\0338");
+    } else if (!completo && escritas == 0) {
+        acrescentarTela(tela, "\nMapa sem alterações (página %d de %d).\n", tela->pagina + 1, paginasDaTela(tela));
+    } else {
+        acrescentarTela(tela, "\n");
+    }
+    tela->paginaDesenhada = tela->pagina;
+
+    // o que o jogo já escreveu com printf sai antes do quadro
+    fflush(tela->destino);
+    fwrite(tela->texto, 1, tela->usados, tela->destino);
+    fflush(tela->destino);
+    return escritas;
+}
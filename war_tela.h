@@ -0,0 +1,55 @@
+/* war_tela.h
+   Desenho incremental do mapa no terminal.
+
+   exibirMapaColunar reescreve a tabela inteira a cada turno, o que num mapa
+   grande são milhares de linhas de printf por jogada. A tela mostra uma
+   página de territórios por vez e guarda o dono e as tropas de cada linha
+   como estavam no último quadro; o quadro seguinte compara só as linhas da
+   página (O(página), não O(territórios)) e reescreve apenas as que mudaram
+   desde então, seja por ataque, investida, desfazer ou reprodução.
+
+   Com ANSI (terminal interativo) o quadro completo limpa a tela e faz das
+   linhas abaixo do mapa uma região de rolagem: o cabeçalho do turno, os
+   resultados das batalhas e o prompt rolam ali sem empurrar o mapa, e os
+   quadros seguintes reescrevem no lugar só as linhas alteradas da tabela,
+   devolvendo o cursor para onde estava, sem apagar nenhuma mensagem.
+   Sem ANSI (saída redirecionada) o quadro lista só as linhas alteradas.
+   O quadro é montado num buffer e sai num único fwrite seguido de fflush.
+*/
+
+#ifndef WAR_TELA_H
+#define WAR_TELA_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "war_mapa.h"
+
+#define LINHAS_POR_PAGINA_PADRAO 20
+
+typedef struct {
+    const Mapa* mapa;
+    FILE* destino;
+    int ansi;               // 1: reescreve as linhas no lugar com códigos ANSI
+    int linhasPorPagina;
+    int pagina;             // página pedida (0 = primeira)
+    int paginaDesenhada;    // página que está na tela, -1 se nenhuma (quadro completo)
+    int rolagem;            // 1: a região de rolagem das mensagens está definida no terminal
+    int* donoDesenhado;     // linhasPorPagina posições: o que está na tela
+    int* tropasDesenhadas;
+    char* texto;            // quadro em montagem
+    size_t usados;
+    size_t capacidade;
+} TelaMapa;
+
+int telaSuportaAnsi(FILE* destino);
+int linhasPorPaginaDoTerminal(FILE* destino);
+int criarTelaMapa(TelaMapa* tela, const Mapa* mapa, FILE* destino, int linhasPorPagina, int ansi);
+void liberarTelaMapa(TelaMapa* tela);
+
+int paginasDaTela(const TelaMapa* tela);
+void mudarPaginaTela(TelaMapa* tela, int pagina);
+void invalidarTela(TelaMapa* tela);
+int desenharTela(TelaMapa* tela);
+
+#endif